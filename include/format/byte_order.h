@@ -0,0 +1,24 @@
+/**
+ * @file byte_order.h
+ * @brief The byte orders used by binary formats and machines.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_BYTE_ORDER_H_
+#define FORMAT_BYTE_ORDER_H_
+
+
+/**
+ * @enum image_byte_order
+ * @brief The byte order used by an image's headers, or by a machine.
+ */
+enum image_byte_order
+{
+    IMAGE_LITTLE_ENDIAN,
+    IMAGE_BIG_ENDIAN
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file elf.h
+ * @brief Recognises ELF objects, executables, and shared objects.
+ *
+ * Every ELF file begins with a 16 byte identification block, which gives the
+ * ELF magic number, the file's word size, and the byte order used by the rest
+ * of the file. elf.h defines the identification block's layout and declares
+ * the ELF backend's entry point for format identification.
+ *
+ * <a href="https://refspecs.linuxfoundation.org/elf/gabi4+/ch4.eheader.html">
+ * https://refspecs.linuxfoundation.org/elf/gabi4+/ch4.eheader.html</a> is
+ * considered to be the definitive reference on the ELF format for the purpose
+ * of this file.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_ELF_ELF_H_
+#define FORMAT_ELF_ELF_H_
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "platform/types.h"
+
+
+#define ELF_IDENT_MAG0      0
+
+#define ELF_IDENT_MAG1      1
+
+#define ELF_IDENT_MAG2      2
+
+#define ELF_IDENT_MAG3      3
+
+#define ELF_IDENT_CLASS     4
+
+#define ELF_IDENT_DATA      5
+
+#define ELF_IDENT_VERSION   6
+
+#define ELF_MAG0            0x7f
+
+#define ELF_MAG1            'E'
+
+#define ELF_MAG2            'L'
+
+#define ELF_MAG3            'F'
+
+#define ELF_CLASS_32        1
+
+#define ELF_CLASS_64        2
+
+#define ELF_DATA_LSB        1
+
+#define ELF_DATA_MSB        2
+
+#define ELF_VERSION_CURRENT 1
+
+/**
+ * @def ELF_MACHINE_OFFSET
+ * @brief The offset of `e_machine` in both the 32 and 64-bit ELF headers.
+ */
+#define ELF_MACHINE_OFFSET  18
+
+/**
+ * @def ELF32_HEADER_SIZE
+ * @brief The size of the ELF header in a 32-bit ELF file, in bytes.
+ */
+#define ELF32_HEADER_SIZE   52
+
+/**
+ * @def ELF64_HEADER_SIZE
+ * @brief The size of the ELF header in a 64-bit ELF file, in bytes.
+ */
+#define ELF64_HEADER_SIZE   64
+
+/**
+ * @brief Tests if an image is an ELF file.
+ *
+ * sniff_elf_image() checks the ELF magic number, and that the identification
+ * block describes a word size and byte order Prim understands.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image is an ELF file; 0 otherwise.
+ */
+int sniff_elf_image(const uint8_ne* data, size_t size, struct image_view* view);
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file format.h
+ * @brief Format agnostic image views, and the registry of format backends.
+ *
+ * Prim supports several binary formats, each implemented by a backend under
+ * `format/<name>/`. format.h lets a caller identify which backend understands
+ * an image without knowing anything about the image in advance.
+ *
+ * Identification only ever inspects the first `IMAGE_SNIFF_SIZE` bytes of an
+ * image. Each backend checks the bytes already in memory for its magic
+ * numbers, so an image is read once no matter how many backends are tried. The
+ * result is a `struct image_view` describing the image in terms shared by all
+ * formats, which the matching backend's functions accept directly.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_FORMAT_H_
+#define FORMAT_FORMAT_H_
+
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "format/byte_order.h"
+#include "platform/types.h"
+
+
+/**
+ * @def IMAGE_SNIFF_SIZE
+ * @brief The number of bytes needed to identify an image's format.
+ *
+ * One page on most hosts. Every backend can identify its images from this
+ * many bytes, but images shorter than `IMAGE_SNIFF_SIZE` are still accepted.
+ */
+#define IMAGE_SNIFF_SIZE    4096
+
+/**
+ * @enum image_format
+ * @brief The binary formats recognised by Prim.
+ */
+enum image_format
+{
+    /** The image was not recognised by any backend. */
+    IMAGE_FORMAT_UNKNOWN,
+
+    /** A PE executable image, with an MS-DOS stub. */
+    IMAGE_FORMAT_PE,
+
+    /** A bare COFF object file. */
+    IMAGE_FORMAT_COFF,
+
+    /** An ELF object, executable, or shared object. */
+    IMAGE_FORMAT_ELF
+};
+
+struct format_backend;
+
+/**
+ * @struct image_view
+ * @brief Describes an image in memory, independent of its binary format.
+ *
+ * An image view does not own or copy the image. `data` points into the
+ * caller's buffer or mapping, which must outlive the view.
+ */
+struct image_view
+{
+    /**
+     * @var data
+     * @brief The first byte of the image.
+     */
+    const uint8_ne* data;
+
+    /**
+     * @var size
+     * @brief The number of bytes of the image available at `data`.
+     */
+    size_t size;
+
+    /**
+     * @var format
+     * @brief The binary format of the image.
+     */
+    enum image_format format;
+
+    /**
+     * @var backend
+     * @brief The backend which recognised the image, or NULL if none did.
+     */
+    const struct format_backend* backend;
+
+    /**
+     * @var header_offset
+     * @brief The offset of the format's primary header from `data`.
+     *
+     * The offset of the COFF header for PE and COFF images, and of the ELF
+     * header for ELF images.
+     */
+    size_t header_offset;
+
+    /**
+     * @var machine
+     * @brief The target machine, as encoded by the image's own format.
+     *
+     * A `COFF_MACH_*` value for PE and COFF images; an ELF `e_machine` value
+     * for ELF images.
+     */
+    uint16_ne machine;
+
+    /**
+     * @var word_size
+     * @brief The native word size of the image, in bits.
+     */
+    unsigned int word_size;
+
+    /**
+     * @var byte_order
+     * @brief The byte order of the image's headers.
+     */
+    enum image_byte_order byte_order;
+};
+
+/**
+ * @struct format_backend
+ * @brief The entry points a binary format backend registers with Prim.
+ */
+struct format_backend
+{
+    /**
+     * @var format
+     * @brief The format implemented by the backend.
+     */
+    enum image_format format;
+
+    /**
+     * @var name
+     * @brief A human readable name for the format.
+     */
+    const char* name;
+
+    /**
+     * @var sniff
+     * @brief Tests if an image belongs to the backend's format.
+     *
+     * `sniff` must only inspect the `size` bytes at `data`, and fills in the
+     * format specific fields of `view` when it recognises the image.
+     *
+     * @return  1 if the image was recognised; 0 otherwise.
+     */
+    int (*sniff)(const uint8_ne* data, size_t size, struct image_view* view);
+};
+
+/**
+ * @brief Identifies the format of an image already in memory.
+ *
+ * sniff_image() offers the image to each registered backend in turn, and
+ * describes the image with the first backend which recognises it. Only the
+ * first `IMAGE_SNIFF_SIZE` bytes are inspected, but `view` covers all `size`
+ * bytes, so a caller with the whole image mapped can hand the view straight
+ * to the backend.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image was recognised; 0 otherwise.
+ */
+int sniff_image(const uint8_ne* data, size_t size, struct image_view* view);
+
+/**
+ * @brief Identifies the format of an image from an open file.
+ *
+ * sniff_image_file() reads up to `page_size` bytes from the current position
+ * of `file` into `page` with a single read, then identifies the image with
+ * sniff_image(). `view` refers to `page`, so the bytes read need not be read
+ * again to parse the image's headers.
+ *
+ * @param   file        The file to read the image from.
+ * @param   page        A buffer of at least `page_size` bytes.
+ * @param   page_size   The size of `page`; normally `IMAGE_SNIFF_SIZE`.
+ * @param   view        Receives the description of the image.
+ * @return  1 if the image was recognised; 0 otherwise, or if `file` could not
+ *          be read.
+ */
+int sniff_image_file(FILE* file,
+                     uint8_ne* page,
+                     size_t page_size,
+                     struct image_view* view);
+
+/**
+ * @brief Returns the human readable name of an image format.
+ *
+ * @param   format  The image format.
+ * @return  A pointer to a human readable format name.
+ */
+const char* get_image_format_name(enum image_format format);
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file filter.h
+ * @brief Filters COFF headers by the machines a host can run.
+ *
+ * A dispatcher choosing an execution backend for many images needs to test
+ * each image's COFF header against the same host many times over. filter.h
+ * resolves a host's `COFF_CAP_*` flags to the set of machine IDs the host can
+ * run once, ahead of time, so testing a header is a handful of integer
+ * comparisons.
+ *
+ * Batches of headers are tested in two passes. mark_coff_machines() takes
+ * the machine IDs and characteristics as separate arrays, and writes an
+ * accept flag for every header. Each of its loops runs over the whole batch,
+ * with no branches and no dependency between headers, so compilers which
+ * vectorise loops (such as GCC at `-O3`) compare many headers per
+ * instruction. compact_coff_matches() then turns the flags into the
+ * positions of the accepted headers.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_PECOFF_FILTER_H_
+#define FORMAT_PECOFF_FILTER_H_
+
+
+#include <stddef.h>
+
+#include "format/pecoff/coff.h"
+#include "platform/types.h"
+
+
+/**
+ * @def MACHINE_FILTER_SIZE
+ * @brief The largest number of machine IDs a filter can accept.
+ *
+ * Large enough for every machine in the PE/COFF specification.
+ */
+#define MACHINE_FILTER_SIZE     32
+
+/**
+ * @def MACHINE_FILTER_BLOCK
+ * @brief The number of headers filter_coff_headers() tests per batch.
+ */
+#define MACHINE_FILTER_BLOCK    256
+
+/**
+ * @struct machine_filter
+ * @brief Selects COFF headers by machine ID and characteristics.
+ */
+struct machine_filter
+{
+    /**
+     * @var machine_ids
+     * @brief The machine IDs accepted by the filter.
+     */
+    uint16_ne machine_ids[MACHINE_FILTER_SIZE];
+
+    /**
+     * @var machine_count
+     * @brief The number of entries in `machine_ids` in use.
+     */
+    unsigned int machine_count;
+
+    /**
+     * @var required_characteristics
+     * @brief Characteristics which must all be set in accepted headers.
+     */
+    uint16_ne required_characteristics;
+
+    /**
+     * @var rejected_characteristics
+     * @brief Characteristics which must all be clear in accepted headers.
+     */
+    uint16_ne rejected_characteristics;
+};
+
+/**
+ * @brief Prepares a filter which accepts the machines with some capabilities.
+ *
+ * Passing `get_host_machine_caps()` as `capabilities` accepts the images the
+ * host can run natively.
+ *
+ * @param   filter          Receives the filter.
+ * @param   capabilities    The `COFF_CAP_*` flags of the accepted machines.
+ * @param   required        Characteristics which accepted headers must set.
+ * @param   rejected        Characteristics which accepted headers must clear.
+ */
+void init_machine_filter(struct machine_filter* filter,
+                         uint32_ne capabilities,
+                         uint16_ne required,
+                         uint16_ne rejected);
+
+/**
+ * @brief Tests if a filter accepts a single COFF header.
+ *
+ * @param   filter  A prepared filter.
+ * @param   header  The COFF header to test.
+ * @return  1 if the filter accepts `header`; 0 otherwise.
+ */
+int is_coff_header_accepted(const struct machine_filter* filter,
+                            const struct coff_header* header);
+
+/**
+ * @brief Tests a batch of headers, given as separate field arrays.
+ *
+ * @param   filter          A prepared filter.
+ * @param   machine_ids     The `machine_id` field of each header.
+ * @param   characteristics The `characteristics` field of each header.
+ * @param   count           The number of headers in the batch.
+ * @param   accepted        Receives 1 for each header the filter accepts,
+ *                          and 0 for each header it rejects.
+ */
+void mark_coff_machines(const struct machine_filter* filter,
+                        const uint16_ne* machine_ids,
+                        const uint16_ne* characteristics,
+                        size_t count,
+                        uint8_ne* accepted);
+
+/**
+ * @brief Lists the positions of the accepted headers in a marked batch.
+ *
+ * @param   accepted    The flags written by mark_coff_machines().
+ * @param   count       The number of headers in the batch.
+ * @param   first       The position of the batch's first header, which is
+ *                      added to every position written to `matches`.
+ * @param   matches     Receives the positions of the accepted headers, in
+ *                      ascending order. Must have room for `count` entries.
+ * @return  The number of headers accepted.
+ */
+size_t compact_coff_matches(const uint8_ne* accepted,
+                            size_t count,
+                            size_t first,
+                            size_t* matches);
+
+/**
+ * @brief Finds the COFF headers a filter accepts in an array.
+ *
+ * filter_coff_headers() copies the headers' fields into separate arrays,
+ * `MACHINE_FILTER_BLOCK` headers at a time, and tests each block with
+ * mark_coff_machines().
+ *
+ * @param   filter  A prepared filter.
+ * @param   headers The COFF headers to test.
+ * @param   count   The number of headers in `headers`.
+ * @param   matches Receives the positions of the accepted headers, in
+ *                  ascending order. Must have room for `count` entries.
+ * @return  The number of headers accepted.
+ */
+size_t filter_coff_headers(const struct machine_filter* filter,
+                           const struct coff_header* headers,
+                           size_t count,
+                           size_t* matches);
+
+#endif
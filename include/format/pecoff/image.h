@@ -0,0 +1,176 @@
+/**
+ * @file image.h
+ * @brief Recognises PE executables and bare COFF object files.
+ *
+ * PE executables begin with an MS-DOS stub, whose header records the offset of
+ * the PE signature. The COFF header follows the signature immediately. COFF
+ * object files have no stub or signature, and begin with the COFF header.
+ *
+ * image.h declares the PE/COFF backend's entry points for format
+ * identification.
+ *
+ * <a href="https://docs.microsoft.com/en-us/windows/win32/debug/pe-format">
+ * https://docs.microsoft.com/en-us/windows/win32/debug/pe-format</a> is
+ * considered to be the definitive reference on the PE/COFF formats for the
+ * the purpose of this file.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_PECOFF_IMAGE_H_
+#define FORMAT_PECOFF_IMAGE_H_
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "format/pecoff/coff.h"
+#include "platform/types.h"
+
+
+/**
+ * @def MSDOS_MAGIC
+ * @brief The "MZ" signature at the start of an MS-DOS stub, read as a little
+ * endian integer.
+ */
+#define MSDOS_MAGIC                 0x5a4d
+
+/**
+ * @def MSDOS_PE_OFFSET_OFFSET
+ * @brief The location of the PE signature's offset in the MS-DOS stub.
+ */
+#define MSDOS_PE_OFFSET_OFFSET      0x3c
+
+/**
+ * @def PE_SIGNATURE
+ * @brief The "PE\0\0" signature preceding the COFF header in a PE image,
+ * read as a little endian integer.
+ */
+#define PE_SIGNATURE                0x00004550
+
+/**
+ * @def PE_SIGNATURE_SIZE
+ * @brief The length of the PE signature, in bytes.
+ */
+#define PE_SIGNATURE_SIZE           4
+
+/**
+ * @def COFF_HEADER_SIZE
+ * @brief The size of the COFF header in a file, in bytes.
+ */
+#define COFF_HEADER_SIZE            20
+
+/**
+ * @def PE32_MAGIC
+ * @brief Identifies a PE32 executable header, with a 32-bit address space.
+ */
+#define PE32_MAGIC                  0x10b
+
+/**
+ * @def PE32_PLUS_MAGIC
+ * @brief Identifies a PE32+ executable header, with a 64-bit address space.
+ */
+#define PE32_PLUS_MAGIC             0x20b
+
+/**
+ * @def PE_DIRECTORY_EXPORT
+ * @brief The index of the export table's data directory.
+ */
+#define PE_DIRECTORY_EXPORT         0
+
+/**
+ * @def PE_DIRECTORY_IMPORT
+ * @brief The index of the import table's data directory.
+ */
+#define PE_DIRECTORY_IMPORT         1
+
+/**
+ * @def PE_DIRECTORY_RESOURCE
+ * @brief The index of the resource table's data directory.
+ */
+#define PE_DIRECTORY_RESOURCE       2
+
+/**
+ * @def PE_DIRECTORY_BASE_RELOCATION
+ * @brief The index of the base relocation table's data directory.
+ */
+#define PE_DIRECTORY_BASE_RELOCATION 5
+
+/**
+ * @struct pe_data_directory
+ * @brief Locates a table described by the executable header.
+ */
+struct pe_data_directory
+{
+    /**
+     * @var rva
+     * @brief The RVA of the table once loaded, or zero if it is absent.
+     */
+    uint32_ne rva;
+
+    /**
+     * @var size
+     * @brief The size of the table, in bytes.
+     */
+    uint32_ne size;
+};
+
+/**
+ * @brief Tests if an image is a PE executable.
+ *
+ * sniff_pe_image() checks for an MS-DOS stub which points to a PE signature
+ * and COFF header.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image is a PE executable; 0 otherwise.
+ */
+int sniff_pe_image(const uint8_ne* data, size_t size, struct image_view* view);
+
+/**
+ * @brief Tests if an image is a bare COFF object file.
+ *
+ * A COFF object has no signature, so sniff_coff_object() accepts an image
+ * only if it begins with a plausible object file COFF header: a known machine
+ * ID other than `COFF_MACH_UNKNOWN`, at least one section, and no executable
+ * header.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image is a COFF object; 0 otherwise.
+ */
+int sniff_coff_object(const uint8_ne* data,
+                      size_t size,
+                      struct image_view* view);
+
+/**
+ * @brief Decodes the COFF header of a PE or COFF image view.
+ *
+ * @param   view    A view of a PE or COFF image.
+ * @param   header  Receives the decoded COFF header.
+ * @return  1 if the header was decoded; 0 if `view` is not a PE or COFF image.
+ */
+int read_coff_header(const struct image_view* view,
+                     struct coff_header* header);
+
+/**
+ * @brief Reads an entry in the data directory of a PE image view.
+ *
+ * The data directory follows the fixed fields of the executable header, whose
+ * layout differs between PE32 and PE32+ images.
+ *
+ * @param   view        A view of a PE image.
+ * @param   index       The index of the directory; a `PE_DIRECTORY_*` value.
+ * @param   directory   Receives the directory entry.
+ * @return  1 if the entry was read; 0 if the image has no such entry, or it
+ *          lies outside the view.
+ */
+int read_pe_data_directory(const struct image_view* view,
+                           unsigned int index,
+                           struct pe_data_directory* directory);
+
+#endif
@@ -23,6 +23,9 @@
 #define FORMAT_PECOFF_MACHINES_H_
 
 
+#include <stddef.h>
+
+#include "format/byte_order.h"
 #include "platform/types.h"
 
 
@@ -76,6 +79,108 @@
 
 #define COFF_MACH_WCEMIPSV2 0x169
 
+/**
+ * @def COFF_CAP_NEUTRAL
+ * @brief Capability to run images which do not depend on a machine.
+ *
+ * Held by `COFF_MACH_UNKNOWN`, which is used by resource only images.
+ */
+#define COFF_CAP_NEUTRAL    0x00000001
+
+#define COFF_CAP_X86        0x00000002
+
+#define COFF_CAP_X86_64     0x00000004
+
+#define COFF_CAP_IA64       0x00000008
+
+#define COFF_CAP_ARM        0x00000010
+
+#define COFF_CAP_ARM64      0x00000020
+
+#define COFF_CAP_MIPS       0x00000040
+
+#define COFF_CAP_POWERPC    0x00000080
+
+#define COFF_CAP_SH         0x00000100
+
+#define COFF_CAP_SH5        0x00000200
+
+#define COFF_CAP_RISCV32    0x00000400
+
+#define COFF_CAP_RISCV64    0x00000800
+
+#define COFF_CAP_RISCV128   0x00001000
+
+#define COFF_CAP_EBC        0x00002000
+
+#define COFF_CAP_AM33       0x00004000
+
+#define COFF_CAP_M32R       0x00008000
+
+/**
+ * @enum coff_machine_isa
+ * @brief The instruction set families of the COFF machine types.
+ */
+enum coff_machine_isa
+{
+    COFF_ISA_NONE,
+    COFF_ISA_X86,
+    COFF_ISA_IA64,
+    COFF_ISA_ARM,
+    COFF_ISA_MIPS,
+    COFF_ISA_POWERPC,
+    COFF_ISA_SH,
+    COFF_ISA_RISCV,
+    COFF_ISA_EBC,
+    COFF_ISA_AM33,
+    COFF_ISA_M32R
+};
+
+/**
+ * @struct coff_machine_info
+ * @brief Describes the properties of a COFF machine type.
+ */
+struct coff_machine_info
+{
+    /**
+     * @var id
+     * @brief The COFF machine ID.
+     */
+    uint16_ne id;
+
+    /**
+     * @var word_size
+     * @brief The native word size of the machine, in bits.
+     *
+     * Zero for `COFF_MACH_UNKNOWN`.
+     */
+    unsigned int word_size;
+
+    /**
+     * @var byte_order
+     * @brief The byte order of the machine.
+     */
+    enum image_byte_order byte_order;
+
+    /**
+     * @var isa
+     * @brief The instruction set family of the machine.
+     */
+    enum coff_machine_isa isa;
+
+    /**
+     * @var capability
+     * @brief The `COFF_CAP_*` flag a host must hold to run the machine's code.
+     */
+    uint32_ne capability;
+
+    /**
+     * @var name
+     * @brief The human readable name of the machine.
+     */
+    const char* name;
+};
+
 /**
  * @brief Returns the human readable representation of a machine ID.
  * 
@@ -99,4 +204,34 @@ const char* get_coff_machine_name(uint16_ne machine_id);
  */
 int is_coff_machine_known(uint16_ne machine_id);
 
+/**
+ * @brief Describes the properties of a machine ID.
+ *
+ * @param   machine_id  The COFF machine ID.
+ * @return  A pointer to the machine's description, or NULL if the machine ID
+ *          is unknown.
+ */
+const struct coff_machine_info* get_coff_machine_info(uint16_ne machine_id);
+
+/**
+ * @brief Lists the properties of every known machine ID.
+ *
+ * @param   count   Receives the number of machines listed.
+ * @return  A pointer to the first machine's description. The descriptions
+ *          are sorted by machine ID.
+ */
+const struct coff_machine_info* list_coff_machines(size_t* count);
+
+/**
+ * @brief Returns the capabilities of the host Prim was compiled for.
+ *
+ * The host's capabilities are the `COFF_CAP_*` flags of the machines it can
+ * run natively, including `COFF_CAP_NEUTRAL`. They are determined when Prim
+ * is compiled, and can be overridden by defining `HOST_MACHINE_CAPS`; for
+ * example, to add the machines an emulator can run.
+ *
+ * @return  The host's `COFF_CAP_*` flags.
+ */
+uint32_ne get_host_machine_caps(void);
+
 #endif
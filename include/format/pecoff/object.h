@@ -0,0 +1,346 @@
+/**
+ * @file object.h
+ * @brief Loads and links COFF object files in memory.
+ *
+ * A COFF object's sections are not ready to run: each section has a table of
+ * relocations, which patch the section's code and data with the addresses of
+ * symbols once the sections have been placed in memory. object.h copies an
+ * object's sections into a caller supplied buffer and applies their
+ * relocations, so compiled objects can be run without an external linker.
+ *
+ * Linking is done in batches. Every symbol is resolved exactly once, in a
+ * single pass over the symbol table, before any relocation is applied. Each
+ * section's relocation table is then applied in one loop specialised for the
+ * object's machine, which finds a relocation's symbol by indexing the
+ * resolved addresses rather than searching the symbol table.
+ *
+ * Relocations are supported for `COFF_MACH_AMD64` and `COFF_MACH_I386`
+ * objects. The deprecated COFF line number tables are ignored.
+ *
+ * Prim does not allocate memory. The caller sizes the buffer for the loaded
+ * sections with get_coff_object_layout(), and provides storage for the
+ * section and symbol addresses.
+ *
+ * <a href="https://docs.microsoft.com/en-us/windows/win32/debug/pe-format">
+ * https://docs.microsoft.com/en-us/windows/win32/debug/pe-format</a> is
+ * considered to be the definitive reference on the PE/COFF formats for the
+ * the purpose of this file.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_PECOFF_OBJECT_H_
+#define FORMAT_PECOFF_OBJECT_H_
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "format/pecoff/coff.h"
+#include "platform/types.h"
+
+
+#define COFF_REL_AMD64_ABSOLUTE     0x0000
+
+#define COFF_REL_AMD64_ADDR64       0x0001
+
+#define COFF_REL_AMD64_ADDR32       0x0002
+
+#define COFF_REL_AMD64_ADDR32NB     0x0003
+
+#define COFF_REL_AMD64_REL32        0x0004
+
+#define COFF_REL_AMD64_REL32_1      0x0005
+
+#define COFF_REL_AMD64_REL32_2      0x0006
+
+#define COFF_REL_AMD64_REL32_3      0x0007
+
+#define COFF_REL_AMD64_REL32_4      0x0008
+
+#define COFF_REL_AMD64_REL32_5      0x0009
+
+#define COFF_REL_AMD64_SECTION      0x000a
+
+#define COFF_REL_AMD64_SECREL       0x000b
+
+#define COFF_REL_I386_ABSOLUTE      0x0000
+
+#define COFF_REL_I386_DIR32         0x0006
+
+#define COFF_REL_I386_DIR32NB       0x0007
+
+#define COFF_REL_I386_SECTION       0x000a
+
+#define COFF_REL_I386_SECREL        0x000b
+
+#define COFF_REL_I386_REL32         0x0014
+
+/**
+ * @def COFF_SYMBOL_UNDEFINED
+ * @brief The section number of a symbol defined outside the object.
+ */
+#define COFF_SYMBOL_UNDEFINED       0
+
+/**
+ * @def COFF_SYMBOL_ABSOLUTE
+ * @brief The section number of a symbol whose value is an absolute address.
+ */
+#define COFF_SYMBOL_ABSOLUTE        -1
+
+/**
+ * @def COFF_SYMBOL_DEBUG
+ * @brief The section number of a symbol which only carries debugging data.
+ */
+#define COFF_SYMBOL_DEBUG           -2
+
+#define COFF_CLASS_EXTERNAL         2
+
+#define COFF_CLASS_STATIC           3
+
+#define COFF_CLASS_SECTION          104
+
+#define COFF_CLASS_WEAK_EXTERNAL    105
+
+/**
+ * @def COFF_UNRESOLVED_ADDRESS
+ * @brief The address recorded for symbols which could not be resolved, and
+ * for sections which are not loaded.
+ */
+#define COFF_UNRESOLVED_ADDRESS     (~(uint64_ne) 0)
+
+/**
+ * @struct coff_object
+ * @brief An open COFF object file.
+ */
+struct coff_object
+{
+    /**
+     * @var view
+     * @brief The COFF object file.
+     */
+    const struct image_view* view;
+
+    /**
+     * @var header
+     * @brief The object's COFF header.
+     */
+    struct coff_header header;
+
+    /**
+     * @var symbols
+     * @brief The object's symbol table, within the image view.
+     */
+    const uint8_ne* symbols;
+
+    /**
+     * @var strings
+     * @brief The object's string table, within the image view.
+     *
+     * String table offsets include the 4 byte size at the start of the table.
+     */
+    const uint8_ne* strings;
+
+    /**
+     * @var strings_size
+     * @brief The size of the string table, in bytes.
+     */
+    uint32_ne strings_size;
+};
+
+/**
+ * @struct coff_symbol
+ * @brief An entry in a COFF object's symbol table.
+ */
+struct coff_symbol
+{
+    /**
+     * @var name
+     * @brief The symbol's name, within the image view.
+     *
+     * The name is not necessarily NUL terminated.
+     */
+    const char* name;
+
+    /**
+     * @var name_length
+     * @brief The length of the symbol's name, in bytes.
+     */
+    size_t name_length;
+
+    /**
+     * @var value
+     * @brief The symbol's value; usually an offset into its section.
+     */
+    uint32_ne value;
+
+    /**
+     * @var section_number
+     * @brief The one based number of the symbol's section, or a
+     * `COFF_SYMBOL_*` value.
+     */
+    int16_ne section_number;
+
+    /**
+     * @var type
+     * @brief The symbol's type.
+     */
+    uint16_ne type;
+
+    /**
+     * @var storage_class
+     * @brief The symbol's storage class; a `COFF_CLASS_*` value.
+     */
+    uint8_ne storage_class;
+
+    /**
+     * @var auxiliary_count
+     * @brief The number of auxiliary records following the symbol.
+     */
+    uint8_ne auxiliary_count;
+};
+
+/**
+ * @typedef coff_symbol_resolver
+ * @brief Finds the address of a symbol defined outside a COFF object.
+ *
+ * Resolvers are also asked to allocate storage for common symbols, which are
+ * undefined symbols with a non zero value giving the storage size needed.
+ *
+ * @param   context     The context given in `struct coff_link`.
+ * @param   name        The symbol's name, which is not NUL terminated.
+ * @param   length      The length of the symbol's name, in bytes.
+ * @param   address     Receives the symbol's address.
+ * @return  1 if the symbol was resolved; 0 otherwise.
+ */
+typedef int (*coff_symbol_resolver)(void* context,
+                                    const char* name,
+                                    size_t length,
+                                    uint64_ne* address);
+
+/**
+ * @struct coff_link
+ * @brief Describes where, and against what, a COFF object is linked.
+ */
+struct coff_link
+{
+    /**
+     * @var memory
+     * @brief The buffer the object's sections are loaded into.
+     */
+    uint8_ne* memory;
+
+    /**
+     * @var memory_size
+     * @brief The size of `memory`, in bytes.
+     */
+    size_t memory_size;
+
+    /**
+     * @var load_address
+     * @brief The address `memory` will be run at.
+     *
+     * Usually the address of `memory` itself. Image relative relocations are
+     * relative to `load_address`, which must be aligned as required by
+     * get_coff_object_layout().
+     *
+     * 32-bit relative references must reach their symbol from `memory`. For
+     * `COFF_MACH_AMD64` objects, calls and jumps to external symbols more
+     * than 2 GiB away are sent through a branch stub loaded after the
+     * sections; any other reference to such a symbol fails to link.
+     */
+    uint64_ne load_address;
+
+    /**
+     * @var section_addresses
+     * @brief Receives the address of each section; one entry per section.
+     *
+     * Sections which are not loaded receive `COFF_UNRESOLVED_ADDRESS`.
+     */
+    uint64_ne* section_addresses;
+
+    /**
+     * @var symbol_addresses
+     * @brief Receives the address of each symbol; one entry per symbol table
+     * record.
+     *
+     * Auxiliary records receive address zero, and symbols which could not be
+     * resolved receive `COFF_UNRESOLVED_ADDRESS`.
+     */
+    uint64_ne* symbol_addresses;
+
+    /**
+     * @var resolve
+     * @brief Resolves symbols defined outside the object. May be NULL.
+     */
+    coff_symbol_resolver resolve;
+
+    /**
+     * @var context
+     * @brief Passed to `resolve`.
+     */
+    void* context;
+};
+
+/**
+ * @brief Opens a COFF object file.
+ *
+ * @param   object  Receives the open object.
+ * @param   view    A view of a COFF object file.
+ * @return  1 if the object was opened; 0 if `view` is not a COFF object, or
+ *          its symbol or string table lies outside the view.
+ */
+int open_coff_object(struct coff_object* object,
+                     const struct image_view* view);
+
+/**
+ * @brief Reads an entry from a COFF object's symbol table.
+ *
+ * @param   object  An open COFF object.
+ * @param   index   The zero based index of the symbol table record.
+ * @param   symbol  Receives the symbol.
+ * @return  1 if the symbol was read; 0 if `index` is out of range, or the
+ *          symbol's name lies outside the string table.
+ */
+int read_coff_symbol(const struct coff_object* object,
+                     uint32_ne index,
+                     struct coff_symbol* symbol);
+
+/**
+ * @brief Calculates the memory needed to load a COFF object.
+ *
+ * Sections marked for removal, linker information, and discardable sections
+ * are not loaded. The size includes a branch stub for each undefined
+ * external symbol of a `COFF_MACH_AMD64` object.
+ *
+ * @param   object      An open COFF object.
+ * @param   size        Receives the size of the buffer needed, in bytes.
+ * @param   alignment   Receives the alignment the buffer's load address
+ *                      needs, in bytes.
+ * @return  1 if the layout was calculated; 0 if a section header could not
+ *          be read, or the size does not fit in a `size_t`.
+ */
+int get_coff_object_layout(const struct coff_object* object,
+                           size_t* size,
+                           size_t* alignment);
+
+/**
+ * @brief Loads a COFF object into memory and applies its relocations.
+ *
+ * Objects for machines other than `COFF_MACH_AMD64` and `COFF_MACH_I386` are
+ * rejected before the buffer is written or any symbol is resolved.
+ *
+ * @param   object  An open COFF object.
+ * @param   link    Describes where the object is loaded, and how external
+ *                  symbols are resolved.
+ * @return  1 if the object was loaded and linked; 0 if the machine is not
+ *          supported, the buffer is too small or misaligned, a referenced
+ *          symbol could not be resolved, a relocation is unsupported or
+ *          overflows, or the object is malformed.
+ */
+int link_coff_object(const struct coff_object* object,
+                     const struct coff_link* link);
+
+#endif
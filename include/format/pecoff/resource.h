@@ -0,0 +1,373 @@
+/**
+ * @file resource.h
+ * @brief Looks up resources in the resource tree of a PE image.
+ *
+ * A PE image's resources are arranged in a three level tree of directories:
+ * resources are first grouped by type, then by name, then by language. Each
+ * directory lists entries named by a string, sorted by string, followed by
+ * entries named by an integer ID, sorted by ID.
+ *
+ * Large GUI images can hold tens of thousands of resources, but callers
+ * typically want a handful. resource.h walks the tree lazily: a directory is
+ * only read when it is opened, and entries are found by binary search over
+ * the directory's entries where they are stored in the image. Like the
+ * Windows loader, lookups trust the sort order the specification requires,
+ * so a lookup never reads more than a logarithmic number of entries, even
+ * when the resource is absent. Callers which handle untrusted images can
+ * check a directory with validate_resource_directory(), or set the tree's
+ * `validate` flag to check every directory as it is opened, including those
+ * opened by find_resource(); malformed directories which are not sorted are
+ * then searched linearly.
+ *
+ * Nothing is copied out of the image. Entries, names, and resource data are
+ * all returned as pointers into the image view, which must outlive them.
+ *
+ * <a href="https://docs.microsoft.com/en-us/windows/win32/debug/pe-format">
+ * https://docs.microsoft.com/en-us/windows/win32/debug/pe-format</a> is
+ * considered to be the definitive reference on the PE/COFF formats for the
+ * the purpose of this file.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_PECOFF_RESOURCE_H_
+#define FORMAT_PECOFF_RESOURCE_H_
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "platform/types.h"
+
+
+#define RESOURCE_TYPE_CURSOR        1
+
+#define RESOURCE_TYPE_BITMAP        2
+
+#define RESOURCE_TYPE_ICON          3
+
+#define RESOURCE_TYPE_MENU          4
+
+#define RESOURCE_TYPE_DIALOG        5
+
+#define RESOURCE_TYPE_STRING        6
+
+#define RESOURCE_TYPE_ACCELERATOR   9
+
+#define RESOURCE_TYPE_RCDATA        10
+
+#define RESOURCE_TYPE_MESSAGE_TABLE 11
+
+#define RESOURCE_TYPE_GROUP_CURSOR  12
+
+#define RESOURCE_TYPE_GROUP_ICON    14
+
+#define RESOURCE_TYPE_VERSION       16
+
+#define RESOURCE_TYPE_MANIFEST      24
+
+/**
+ * @def RESOURCE_LANGUAGE_ANY
+ * @brief Matches the first language a resource is available in.
+ */
+#define RESOURCE_LANGUAGE_ANY       0xffffffff
+
+/**
+ * @struct resource_tree
+ * @brief Locates the resource tree of a PE image.
+ */
+struct resource_tree
+{
+    /**
+     * @var view
+     * @brief The PE image holding the resource tree.
+     */
+    const struct image_view* view;
+
+    /**
+     * @var base
+     * @brief The root directory of the tree, within the image view.
+     *
+     * Offsets inside the resource tree are relative to `base`.
+     */
+    const uint8_ne* base;
+
+    /**
+     * @var size
+     * @brief The number of bytes of the resource tree available at `base`.
+     */
+    uint32_ne size;
+
+    /**
+     * @var rva
+     * @brief The RVA of the root directory.
+     */
+    uint32_ne rva;
+
+    /**
+     * @var validate
+     * @brief If nonzero, directories are checked with
+     * validate_resource_directory() when they are opened.
+     *
+     * Cleared by open_resource_tree(). Checking reads every entry of each
+     * directory opened, so lookups in unsorted directories still succeed.
+     */
+    int validate;
+};
+
+/**
+ * @enum resource_sort_state
+ * @brief Records what is known about the sort order of directory entries.
+ */
+enum resource_sort_state
+{
+    /** The entries have not been checked, and are assumed to be sorted. */
+    RESOURCE_ORDER_UNCHECKED,
+
+    /** The entries have been checked, and are sorted. */
+    RESOURCE_ORDER_SORTED,
+
+    /** The entries have been checked, and are not sorted. */
+    RESOURCE_ORDER_UNSORTED
+};
+
+/**
+ * @struct resource_directory
+ * @brief An open directory in a resource tree.
+ */
+struct resource_directory
+{
+    /**
+     * @var tree
+     * @brief The tree the directory belongs to.
+     */
+    const struct resource_tree* tree;
+
+    /**
+     * @var entries
+     * @brief The directory's first entry, within the image view.
+     */
+    const uint8_ne* entries;
+
+    /**
+     * @var name_count
+     * @brief The number of entries named by a string.
+     *
+     * Entries named by a string precede the entries named by an ID.
+     */
+    uint16_ne name_count;
+
+    /**
+     * @var id_count
+     * @brief The number of entries named by an integer ID.
+     */
+    uint16_ne id_count;
+
+    /**
+     * @var name_order
+     * @brief The sort order of the entries named by a string.
+     */
+    enum resource_sort_state name_order;
+
+    /**
+     * @var id_order
+     * @brief The sort order of the entries named by an ID.
+     */
+    enum resource_sort_state id_order;
+};
+
+/**
+ * @struct resource_entry
+ * @brief An entry in a resource directory.
+ *
+ * An entry names either a subdirectory or the resource data itself.
+ */
+struct resource_entry
+{
+    /**
+     * @var tree
+     * @brief The tree the entry belongs to.
+     */
+    const struct resource_tree* tree;
+
+    /**
+     * @var name
+     * @brief The entry's integer ID, or the offset of its name string with
+     * the high bit set.
+     */
+    uint32_ne name;
+
+    /**
+     * @var target
+     * @brief The offset of the entry's data, or of its subdirectory with the
+     * high bit set.
+     */
+    uint32_ne target;
+};
+
+/**
+ * @struct resource_data
+ * @brief The data of a resource.
+ */
+struct resource_data
+{
+    /**
+     * @var data
+     * @brief The first byte of the resource, within the image view.
+     */
+    const uint8_ne* data;
+
+    /**
+     * @var size
+     * @brief The size of the resource, in bytes.
+     */
+    uint32_ne size;
+
+    /**
+     * @var codepage
+     * @brief The code page used to decode text in the resource.
+     */
+    uint32_ne codepage;
+};
+
+/**
+ * @brief Locates the resource tree of a PE image.
+ *
+ * @param   tree    Receives the location of the resource tree.
+ * @param   view    A view of a PE image, in its file layout.
+ * @return  1 if the image has a resource tree; 0 otherwise.
+ */
+int open_resource_tree(struct resource_tree* tree,
+                       const struct image_view* view);
+
+/**
+ * @brief Opens the root directory of a resource tree.
+ *
+ * The root directory's entries are resource types.
+ *
+ * @param   tree        An open resource tree.
+ * @param   directory   Receives the root directory.
+ * @return  1 if the directory was opened; 0 if it lies outside the image.
+ */
+int open_resource_root(const struct resource_tree* tree,
+                       struct resource_directory* directory);
+
+/**
+ * @brief Opens the subdirectory named by a directory entry.
+ *
+ * @param   entry       An entry which names a subdirectory.
+ * @param   directory   Receives the subdirectory.
+ * @return  1 if the directory was opened; 0 if `entry` names resource data,
+ *          or the directory lies outside the image.
+ */
+int open_resource_subdirectory(const struct resource_entry* entry,
+                               struct resource_directory* directory);
+
+/**
+ * @brief Checks that a directory's entries are sorted.
+ *
+ * validate_resource_directory() reads every entry in the directory, and
+ * records the result in `directory`. Later searches of a directory found to
+ * be unsorted fall back to a linear scan, so they still find every entry.
+ *
+ * @param   directory   An open directory.
+ * @return  1 if the directory's entries are sorted; 0 otherwise.
+ */
+int validate_resource_directory(struct resource_directory* directory);
+
+/**
+ * @brief Reads an entry from a directory by its position.
+ *
+ * @param   directory   An open directory.
+ * @param   index       The zero based position of the entry.
+ * @param   entry       Receives the entry.
+ * @return  1 if the entry was read; 0 if `index` is out of range.
+ */
+int get_resource_entry(const struct resource_directory* directory,
+                       unsigned int index,
+                       struct resource_entry* entry);
+
+/**
+ * @brief Finds the entry with an integer ID in a directory.
+ *
+ * @param   directory   An open directory.
+ * @param   id          The ID to find.
+ * @param   entry       Receives the entry.
+ * @return  1 if the entry was found; 0 otherwise.
+ */
+int find_resource_id(const struct resource_directory* directory,
+                     uint32_ne id,
+                     struct resource_entry* entry);
+
+/**
+ * @brief Finds the entry with a string name in a directory.
+ *
+ * Names are compared by UTF-16 code unit, ignoring the case of ASCII letters.
+ *
+ * @param   directory   An open directory.
+ * @param   name        The name to find, as UTF-16 code units.
+ * @param   length      The number of code units in `name`.
+ * @param   entry       Receives the entry.
+ * @return  1 if the entry was found; 0 otherwise.
+ */
+int find_resource_name(const struct resource_directory* directory,
+                       const uint16_ne* name,
+                       size_t length,
+                       struct resource_entry* entry);
+
+/**
+ * @brief Indicates if a directory entry names a subdirectory.
+ *
+ * @param   entry   A directory entry.
+ * @return  1 if `entry` names a subdirectory; 0 if it names resource data.
+ */
+int is_resource_subdirectory(const struct resource_entry* entry);
+
+/**
+ * @brief Gets the string name of a directory entry.
+ *
+ * @param   entry   A directory entry.
+ * @param   name    Receives the name, as little endian UTF-16 code units
+ *                  within the image view.
+ * @param   length  Receives the number of code units in the name.
+ * @return  1 if the name was read; 0 if `entry` is named by an ID, or the name
+ *          lies outside the image.
+ */
+int get_resource_name(const struct resource_entry* entry,
+                      const uint8_ne** name,
+                      uint16_ne* length);
+
+/**
+ * @brief Reads the resource data named by a directory entry.
+ *
+ * @param   entry   An entry which names resource data.
+ * @param   data    Receives the resource data.
+ * @return  1 if the data was read; 0 if `entry` names a subdirectory, or the
+ *          data lies outside the image.
+ */
+int read_resource_data(const struct resource_entry* entry,
+                       struct resource_data* data);
+
+/**
+ * @brief Finds a resource by its type, ID, and language.
+ *
+ * find_resource() opens only the three directories on the path to the
+ * resource. Each is checked first if the tree's `validate` flag is set;
+ * otherwise the directories are trusted to be sorted.
+ *
+ * @param   tree        An open resource tree.
+ * @param   type        The resource type; a `RESOURCE_TYPE_*` value.
+ * @param   id          The resource ID.
+ * @param   language    The language ID, or `RESOURCE_LANGUAGE_ANY`.
+ * @param   data        Receives the resource data.
+ * @return  1 if the resource was found; 0 otherwise.
+ */
+int find_resource(const struct resource_tree* tree,
+                  uint32_ne type,
+                  uint32_ne id,
+                  uint32_ne language,
+                  struct resource_data* data);
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file section.h
+ * @brief Describes the section table used by COFF objects and PE executables.
+ *
+ * The section table immediately follows the COFF header and executable header,
+ * and has one entry for each section counted by the COFF header. Each entry
+ * locates the section's raw data in the file, and in a PE image gives the
+ * section's relative virtual address (RVA) once loaded.
+ *
+ * section.h describes the format of section table entries, and declares
+ * functions to read section headers and translate RVAs to file offsets.
+ *
+ * <a href="https://docs.microsoft.com/en-us/windows/win32/debug/pe-format">
+ * https://docs.microsoft.com/en-us/windows/win32/debug/pe-format</a> is
+ * considered to be the definitive reference on the PE/COFF formats for the
+ * the purpose of this file.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef FORMAT_PECOFF_SECTION_H_
+#define FORMAT_PECOFF_SECTION_H_
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "platform/types.h"
+
+
+/**
+ * @def SECTION_HEADER_SIZE
+ * @brief The size of a section table entry in the file, in bytes.
+ */
+#define SECTION_HEADER_SIZE     40
+
+/**
+ * @def SECTION_NAME_SIZE
+ * @brief The size of the name field in a section table entry, in bytes.
+ */
+#define SECTION_NAME_SIZE       8
+
+/**
+ * @def SECTION_CODE
+ * @brief The section contains executable code.
+ */
+#define SECTION_CODE                    0x00000020
+
+/**
+ * @def SECTION_INITIALISED_DATA
+ * @brief The section contains initialised data.
+ */
+#define SECTION_INITIALISED_DATA        0x00000040
+
+/**
+ * @def SECTION_UNINITIALISED_DATA
+ * @brief The section contains uninitialised data, which is zero filled.
+ */
+#define SECTION_UNINITIALISED_DATA      0x00000080
+
+/**
+ * @def SECTION_LINK_INFO
+ * @brief The section holds comments or linker directives. Objects only.
+ */
+#define SECTION_LINK_INFO               0x00000200
+
+/**
+ * @def SECTION_LINK_REMOVE
+ * @brief The section will not become part of the image. Objects only.
+ */
+#define SECTION_LINK_REMOVE             0x00000800
+
+/**
+ * @def SECTION_ALIGN_MASK
+ * @brief Selects the alignment field of an object's section.
+ *
+ * A non zero field value `n` aligns the section to `1 << (n - 1)` bytes.
+ */
+#define SECTION_ALIGN_MASK              0x00f00000
+
+/**
+ * @def SECTION_ALIGN_SHIFT
+ * @brief The position of the alignment field of an object's section.
+ */
+#define SECTION_ALIGN_SHIFT             20
+
+/**
+ * @def SECTION_EXTENDED_RELOCATIONS
+ * @brief The section has more than 65534 relocations.
+ *
+ * The relocation count is then 0xffff, and the real count is stored in the
+ * first relocation, which is not otherwise used.
+ */
+#define SECTION_EXTENDED_RELOCATIONS    0x01000000
+
+/**
+ * @def SECTION_DISCARDABLE
+ * @brief The section can be discarded once loaded; typically debug data.
+ */
+#define SECTION_DISCARDABLE             0x02000000
+
+/**
+ * @def SECTION_EXECUTE
+ * @brief The section can be executed as code.
+ */
+#define SECTION_EXECUTE                 0x20000000
+
+/**
+ * @def SECTION_READ
+ * @brief The section can be read.
+ */
+#define SECTION_READ                    0x40000000
+
+/**
+ * @def SECTION_WRITE
+ * @brief The section can be written to.
+ */
+#define SECTION_WRITE                   0x80000000
+
+/**
+ * @struct section_header
+ * @brief Sets out the section table entry format used in PE/COFF binaries.
+ */
+struct section_header
+{
+    /**
+     * @var name
+     * @brief The section's name, padded with NUL bytes.
+     *
+     * The name is not NUL terminated if it is exactly eight bytes long.
+     * Object files with longer names store "/" and a decimal offset into the
+     * string table instead.
+     */
+    char name[SECTION_NAME_SIZE];
+
+    /**
+     * @var virtual_size
+     * @brief The size of the section once loaded into memory.
+     *
+     * Zero in COFF object files.
+     */
+    uint32_ne virtual_size;
+
+    /**
+     * @var virtual_address
+     * @brief The RVA of the section once loaded into memory.
+     *
+     * COFF object files should set the virtual address to zero.
+     */
+    uint32_ne virtual_address;
+
+    /**
+     * @var raw_data_size
+     * @brief The size of the section's initialised data in the file.
+     */
+    uint32_ne raw_data_size;
+
+    /**
+     * @var raw_data_offset
+     * @brief The file offset of the section's initialised data.
+     *
+     * Zero if the section only contains uninitialised data.
+     */
+    uint32_ne raw_data_offset;
+
+    /**
+     * @var relocations_offset
+     * @brief The file offset of the section's COFF relocation table.
+     *
+     * Zero in PE executables, which use base relocations instead.
+     */
+    uint32_ne relocations_offset;
+
+    /**
+     * @var line_numbers_offset
+     * @brief Deprecated. Should be zero.
+     *
+     * @deprecated The file offset of the section's COFF line number table.
+     */
+    uint32_ne line_numbers_offset;
+
+    /**
+     * @var relocation_count
+     * @brief The number of entries in the section's relocation table.
+     */
+    uint16_ne relocation_count;
+
+    /**
+     * @var line_number_count
+     * @brief Deprecated. Should be zero.
+     *
+     * @deprecated The number of entries in the section's line number table.
+     */
+    uint16_ne line_number_count;
+
+    /**
+     * @var characteristics
+     * @brief Flags which describe the section's contents and permissions.
+     */
+    uint32_ne characteristics;
+};
+
+/**
+ * @brief Decodes an entry in the section table of a PE or COFF image view.
+ *
+ * @param   view    A view of a PE or COFF image.
+ * @param   index   The zero based index of the section.
+ * @param   header  Receives the decoded section header.
+ * @return  1 if the section header was decoded; 0 if the section does not
+ *          exist, or lies outside the view.
+ */
+int read_section_header(const struct image_view* view,
+                        unsigned int index,
+                        struct section_header* header);
+
+/**
+ * @brief Translates an RVA to an offset into a PE image view.
+ *
+ * map_image_rva() finds the section which holds the `size` bytes at `rva`,
+ * and returns their location in the file. The whole range must lie within the
+ * section's initialised data.
+ *
+ * @param   view    A view of a PE image, in its file layout.
+ * @param   rva     The relative virtual address to translate.
+ * @param   size    The number of bytes which must be available at `rva`.
+ * @param   offset  Receives the offset of `rva` from the start of the view.
+ * @return  1 if the range was mapped; 0 if no section holds it, or it lies
+ *          outside the view.
+ */
+int map_image_rva(const struct image_view* view,
+                  uint32_ne rva,
+                  uint32_ne size,
+                  size_t* offset);
+
+#endif
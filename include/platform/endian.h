@@ -0,0 +1,92 @@
+/**
+ * @file endian.h
+ * @brief Byte order aware access to raw image bytes.
+ *
+ * Binary formats fix the byte order of their fields, but the host Prim runs on
+ * may use a different byte order, and a field inside a mapped image is not
+ * guaranteed to be aligned for the host. The macros in platform/endian.h read
+ * and write fixed width integers one byte at a time, so they are correct for
+ * any host byte order and any alignment.
+ *
+ * The arguments are evaluated more than once, so they should not have side
+ * effects.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+#ifndef PLATFORM_ENDIAN_H_
+#define PLATFORM_ENDIAN_H_
+
+
+#include "platform/types.h"
+
+
+/**
+ * @def READ_UINT16_LE
+ * @brief Reads a little endian, 16 bit, unsigned integer from a byte pointer.
+ */
+#define READ_UINT16_LE(p) \
+    ((uint16_ne) ((uint16_ne) (p)[0] | (uint16_ne) ((uint16_ne) (p)[1] << 8)))
+
+/**
+ * @def READ_UINT32_LE
+ * @brief Reads a little endian, 32 bit, unsigned integer from a byte pointer.
+ */
+#define READ_UINT32_LE(p) \
+    ((uint32_ne) (p)[0] \
+     | ((uint32_ne) (p)[1] << 8) \
+     | ((uint32_ne) (p)[2] << 16) \
+     | ((uint32_ne) (p)[3] << 24))
+
+/**
+ * @def READ_UINT64_LE
+ * @brief Reads a little endian, 64 bit, unsigned integer from a byte pointer.
+ */
+#define READ_UINT64_LE(p) \
+    ((uint64_ne) READ_UINT32_LE(p) \
+     | ((uint64_ne) READ_UINT32_LE((p) + 4) << 32))
+
+/**
+ * @def READ_UINT16_BE
+ * @brief Reads a big endian, 16 bit, unsigned integer from a byte pointer.
+ */
+#define READ_UINT16_BE(p) \
+    ((uint16_ne) ((uint16_ne) ((uint16_ne) (p)[0] << 8) | (uint16_ne) (p)[1]))
+
+/**
+ * @def READ_UINT32_BE
+ * @brief Reads a big endian, 32 bit, unsigned integer from a byte pointer.
+ */
+#define READ_UINT32_BE(p) \
+    (((uint32_ne) (p)[0] << 24) \
+     | ((uint32_ne) (p)[1] << 16) \
+     | ((uint32_ne) (p)[2] << 8) \
+     | (uint32_ne) (p)[3])
+
+/**
+ * @def WRITE_UINT16_LE
+ * @brief Writes a little endian, 16 bit, unsigned integer to a byte pointer.
+ */
+#define WRITE_UINT16_LE(p, value) \
+    ((p)[0] = (uint8_ne) ((value) & 0xff), \
+     (p)[1] = (uint8_ne) (((value) >> 8) & 0xff))
+
+/**
+ * @def WRITE_UINT32_LE
+ * @brief Writes a little endian, 32 bit, unsigned integer to a byte pointer.
+ */
+#define WRITE_UINT32_LE(p, value) \
+    (WRITE_UINT16_LE(p, (value) & 0xffff), \
+     WRITE_UINT16_LE((p) + 2, ((value) >> 16) & 0xffff))
+
+/**
+ * @def WRITE_UINT64_LE
+ * @brief Writes a little endian, 64 bit, unsigned integer to a byte pointer.
+ */
+#define WRITE_UINT64_LE(p, value) \
+    (WRITE_UINT32_LE(p, (value) & 0xffffffff), \
+     WRITE_UINT32_LE((p) + 4, ((value) >> 32) & 0xffffffff))
+
+#endif
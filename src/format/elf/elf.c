@@ -0,0 +1,70 @@
+/**
+ * @file elf.c
+ * @brief Recognises ELF objects, executables, and shared objects.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+
+#include "format/elf/elf.h"
+#include "format/format.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @brief Tests if an image is an ELF file.
+ *
+ * @see elf.h for more information.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image is an ELF file; 0 otherwise.
+ */
+int sniff_elf_image(const uint8_ne* data, size_t size, struct image_view* view)
+{
+    if (size < ELF32_HEADER_SIZE
+        || data[ELF_IDENT_MAG0] != ELF_MAG0
+        || data[ELF_IDENT_MAG1] != ELF_MAG1
+        || data[ELF_IDENT_MAG2] != ELF_MAG2
+        || data[ELF_IDENT_MAG3] != ELF_MAG3
+        || data[ELF_IDENT_VERSION] != ELF_VERSION_CURRENT)
+    {
+        return 0;
+    }
+    switch (data[ELF_IDENT_CLASS])
+    {
+    case ELF_CLASS_32:
+        view->word_size = 32;
+        break;
+    case ELF_CLASS_64:
+        if (size < ELF64_HEADER_SIZE)
+        {
+            return 0;
+        }
+        view->word_size = 64;
+        break;
+    default:
+        return 0;
+    }
+    switch (data[ELF_IDENT_DATA])
+    {
+    case ELF_DATA_LSB:
+        view->byte_order = IMAGE_LITTLE_ENDIAN;
+        view->machine = READ_UINT16_LE(data + ELF_MACHINE_OFFSET);
+        break;
+    case ELF_DATA_MSB:
+        view->byte_order = IMAGE_BIG_ENDIAN;
+        view->machine = READ_UINT16_BE(data + ELF_MACHINE_OFFSET);
+        break;
+    default:
+        return 0;
+    }
+    view->header_offset = 0;
+    return 1;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file format.c
+ * @brief The registry of format backends, and format agnostic image views.
+ *
+ * format.c lists the backends Prim was built with, and offers images to each
+ * backend until one recognises the image.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "format/elf/elf.h"
+#include "format/format.h"
+#include "format/pecoff/image.h"
+#include "platform/types.h"
+
+
+/**
+ * @var format_backends
+ * @brief The format backends, in the order images are offered to them.
+ *
+ * Backends with strong magic numbers are tried first. COFF objects have no
+ * magic number, so the COFF backend is tried last to avoid misidentifying
+ * other formats.
+ */
+const struct format_backend format_backends[] =
+{
+    {IMAGE_FORMAT_ELF,      "ELF",      sniff_elf_image},
+    {IMAGE_FORMAT_PE,       "PE",       sniff_pe_image},
+    {IMAGE_FORMAT_COFF,     "COFF",     sniff_coff_object},
+};
+
+/**
+ * @brief Identifies the format of an image already in memory.
+ *
+ * @see format.h for more information.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image was recognised; 0 otherwise.
+ */
+int sniff_image(const uint8_ne* data, size_t size, struct image_view* view)
+{
+    size_t sniff_size = size < IMAGE_SNIFF_SIZE ? size : IMAGE_SNIFF_SIZE;
+    unsigned int i;
+    view->data = data;
+    view->size = size;
+    for (i = 0;
+         i < sizeof(format_backends) / sizeof(struct format_backend);
+         i++)
+    {
+        if (format_backends[i].sniff(data, sniff_size, view))
+        {
+            view->format = format_backends[i].format;
+            view->backend = &format_backends[i];
+            return 1;
+        }
+    }
+    view->format = IMAGE_FORMAT_UNKNOWN;
+    view->backend = NULL;
+    view->header_offset = 0;
+    view->machine = 0;
+    view->word_size = 0;
+    view->byte_order = IMAGE_LITTLE_ENDIAN;
+    return 0;
+}
+
+/**
+ * @brief Identifies the format of an image from an open file.
+ *
+ * @see format.h for more information.
+ *
+ * @param   file        The file to read the image from.
+ * @param   page        A buffer of at least `page_size` bytes.
+ * @param   page_size   The size of `page`; normally `IMAGE_SNIFF_SIZE`.
+ * @param   view        Receives the description of the image.
+ * @return  1 if the image was recognised; 0 otherwise, or if `file` could not
+ *          be read.
+ */
+int sniff_image_file(FILE* file,
+                     uint8_ne* page,
+                     size_t page_size,
+                     struct image_view* view)
+{
+    size_t read_size = fread(page, 1, page_size, file);
+    if (read_size < page_size && ferror(file))
+    {
+        read_size = 0;
+    }
+    return sniff_image(page, read_size, view);
+}
+
+/**
+ * @brief Returns the human readable name of an image format.
+ *
+ * @param   format  The image format.
+ * @return  A pointer to a human readable format name.
+ */
+const char* get_image_format_name(enum image_format format)
+{
+    static const char* const unrecognised_format = "Unrecognised format";
+    unsigned int i;
+    for (i = 0;
+         i < sizeof(format_backends) / sizeof(struct format_backend);
+         i++)
+    {
+        if (format_backends[i].format == format)
+        {
+            return format_backends[i].name;
+        }
+    }
+    return unrecognised_format;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file filter.c
+ * @brief Filters COFF headers by the machines a host can run.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+
+#include "format/pecoff/coff.h"
+#include "format/pecoff/filter.h"
+#include "format/pecoff/machines.h"
+#include "platform/types.h"
+
+
+/**
+ * @def ACCEPTED_CHARACTERISTICS
+ * @brief The flag mark_coff_machines() sets for acceptable characteristics.
+ */
+#define ACCEPTED_CHARACTERISTICS    0x01
+
+/**
+ * @def ACCEPTED_MACHINE
+ * @brief The flag mark_coff_machines() sets for accepted machine IDs.
+ */
+#define ACCEPTED_MACHINE            0x02
+
+/**
+ * @brief Prepares a filter which accepts the machines with some capabilities.
+ *
+ * @see filter.h for more information.
+ *
+ * @param   filter          Receives the filter.
+ * @param   capabilities    The `COFF_CAP_*` flags of the accepted machines.
+ * @param   required        Characteristics which accepted headers must set.
+ * @param   rejected        Characteristics which accepted headers must clear.
+ */
+void init_machine_filter(struct machine_filter* filter,
+                         uint32_ne capabilities,
+                         uint16_ne required,
+                         uint16_ne rejected)
+{
+    const struct coff_machine_info* machines;
+    size_t machine_count;
+    unsigned int i;
+    machines = list_coff_machines(&machine_count);
+    filter->machine_count = 0;
+    for (i = 0;
+         i < machine_count && filter->machine_count < MACHINE_FILTER_SIZE;
+         i++)
+    {
+        if (machines[i].capability & capabilities)
+        {
+            filter->machine_ids[filter->machine_count++] = machines[i].id;
+        }
+    }
+    filter->required_characteristics = required;
+    filter->rejected_characteristics = rejected;
+}
+
+/**
+ * @brief Tests if a filter accepts a single COFF header.
+ *
+ * @param   filter  A prepared filter.
+ * @param   header  The COFF header to test.
+ * @return  1 if the filter accepts `header`; 0 otherwise.
+ */
+int is_coff_header_accepted(const struct machine_filter* filter,
+                            const struct coff_header* header)
+{
+    unsigned int i;
+    if ((header->characteristics & filter->required_characteristics)
+            != filter->required_characteristics
+        || header->characteristics & filter->rejected_characteristics)
+    {
+        return 0;
+    }
+    for (i = 0; i < filter->machine_count; i++)
+    {
+        if (header->machine_id == filter->machine_ids[i])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Tests a batch of headers, given as separate field arrays.
+ *
+ * The characteristics of every header are tested first, then each accepted
+ * machine ID is compared against every header in turn. Every loop over the
+ * batch is free of branches and of dependencies between headers.
+ *
+ * @param   filter          A prepared filter.
+ * @param   machine_ids     The `machine_id` field of each header.
+ * @param   characteristics The `characteristics` field of each header.
+ * @param   count           The number of headers in the batch.
+ * @param   accepted        Receives 1 for each header the filter accepts,
+ *                          and 0 for each header it rejects.
+ */
+void mark_coff_machines(const struct machine_filter* filter,
+                        const uint16_ne* machine_ids,
+                        const uint16_ne* characteristics,
+                        size_t count,
+                        uint8_ne* accepted)
+{
+    uint16_ne required = filter->required_characteristics;
+    uint16_ne rejected = filter->rejected_characteristics;
+    unsigned int j;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        accepted[i] = (uint8_ne) (((characteristics[i] & required) == required)
+                                  & ((characteristics[i] & rejected) == 0));
+    }
+    for (j = 0; j < filter->machine_count; j++)
+    {
+        uint16_ne machine_id = filter->machine_ids[j];
+        for (i = 0; i < count; i++)
+        {
+            accepted[i] |= (uint8_ne) ((machine_ids[i] == machine_id)
+                                       * ACCEPTED_MACHINE);
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        accepted[i] = (uint8_ne) ((accepted[i] >> 1) & accepted[i]
+                                  & ACCEPTED_CHARACTERISTICS);
+    }
+}
+
+/**
+ * @brief Lists the positions of the accepted headers in a marked batch.
+ *
+ * Every position is written to `matches`, but the output position only
+ * advances past accepted headers, so the loop never branches on a flag.
+ *
+ * @param   accepted    The flags written by mark_coff_machines().
+ * @param   count       The number of headers in the batch.
+ * @param   first       The position of the batch's first header, which is
+ *                      added to every position written to `matches`.
+ * @param   matches     Receives the positions of the accepted headers, in
+ *                      ascending order. Must have room for `count` entries.
+ * @return  The number of headers accepted.
+ */
+size_t compact_coff_matches(const uint8_ne* accepted,
+                            size_t count,
+                            size_t first,
+                            size_t* matches)
+{
+    size_t match_count = 0;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        matches[match_count] = first + i;
+        match_count += accepted[i];
+    }
+    return match_count;
+}
+
+/**
+ * @brief Finds the COFF headers a filter accepts in an array.
+ *
+ * @see filter.h for more information.
+ *
+ * @param   filter  A prepared filter.
+ * @param   headers The COFF headers to test.
+ * @param   count   The number of headers in `headers`.
+ * @param   matches Receives the positions of the accepted headers, in
+ *                  ascending order. Must have room for `count` entries.
+ * @return  The number of headers accepted.
+ */
+size_t filter_coff_headers(const struct machine_filter* filter,
+                           const struct coff_header* headers,
+                           size_t count,
+                           size_t* matches)
+{
+    uint16_ne machine_ids[MACHINE_FILTER_BLOCK];
+    uint16_ne characteristics[MACHINE_FILTER_BLOCK];
+    uint8_ne accepted[MACHINE_FILTER_BLOCK];
+    size_t match_count = 0;
+    size_t first;
+    for (first = 0; first < count; first += MACHINE_FILTER_BLOCK)
+    {
+        size_t block = count - first < MACHINE_FILTER_BLOCK
+            ? count - first
+            : MACHINE_FILTER_BLOCK;
+        size_t i;
+        for (i = 0; i < block; i++)
+        {
+            machine_ids[i] = headers[first + i].machine_id;
+            characteristics[i] = headers[first + i].characteristics;
+        }
+        mark_coff_machines(filter,
+                           machine_ids,
+                           characteristics,
+                           block,
+                           accepted);
+        match_count += compact_coff_matches(accepted,
+                                            block,
+                                            first,
+                                            matches + match_count);
+    }
+    return match_count;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file image.c
+ * @brief Recognises PE executables and bare COFF object files.
+ *
+ * image.c implements the PE/COFF backend's format identification, and decodes
+ * the COFF header of recognised images.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "format/pecoff/characteristics.h"
+#include "format/pecoff/coff.h"
+#include "format/pecoff/image.h"
+#include "format/pecoff/machines.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @def PE32_DIRECTORY_OFFSET
+ * @brief The offset of the data directory in a PE32 executable header.
+ *
+ * The directory is preceded by a 32-bit count of its entries.
+ */
+#define PE32_DIRECTORY_OFFSET       96
+
+/**
+ * @def PE32_PLUS_DIRECTORY_OFFSET
+ * @brief The offset of the data directory in a PE32+ executable header.
+ *
+ * The directory is preceded by a 32-bit count of its entries.
+ */
+#define PE32_PLUS_DIRECTORY_OFFSET  112
+
+/**
+ * @def PE_DIRECTORY_ENTRY_SIZE
+ * @brief The size of a data directory entry, in bytes.
+ */
+#define PE_DIRECTORY_ENTRY_SIZE     8
+
+/**
+ * @brief Decodes a COFF header from raw little endian bytes.
+ *
+ * @param   bytes   The first byte of a COFF header in the file.
+ * @param   header  Receives the decoded header.
+ */
+static void decode_coff_header(const uint8_ne* bytes,
+                               struct coff_header* header)
+{
+    header->machine_id = READ_UINT16_LE(bytes);
+    header->section_count = READ_UINT16_LE(bytes + 2);
+    header->timestamp = READ_UINT32_LE(bytes + 4);
+    header->symbol_table_offset = READ_UINT32_LE(bytes + 8);
+    header->symbol_count = READ_UINT32_LE(bytes + 12);
+    header->executable_header_size = READ_UINT16_LE(bytes + 16);
+    header->characteristics = READ_UINT16_LE(bytes + 18);
+}
+
+/**
+ * @brief Guesses the word size of a machine which has no executable header.
+ *
+ * @param   machine_id  The COFF machine ID.
+ * @return  The native word size of the machine, in bits.
+ */
+static unsigned int get_machine_word_size(uint16_ne machine_id)
+{
+    const struct coff_machine_info* info = get_coff_machine_info(machine_id);
+    return info != NULL && info->word_size != 0 ? info->word_size : 32;
+}
+
+/**
+ * @brief Tests if an image is a PE executable.
+ *
+ * @see image.h for more information.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image is a PE executable; 0 otherwise.
+ */
+int sniff_pe_image(const uint8_ne* data, size_t size, struct image_view* view)
+{
+    struct coff_header header;
+    uint32_ne pe_offset;
+    size_t coff_offset;
+    size_t magic_offset;
+    if (size < MSDOS_PE_OFFSET_OFFSET + 4
+        || READ_UINT16_LE(data) != MSDOS_MAGIC)
+    {
+        return 0;
+    }
+    pe_offset = READ_UINT32_LE(data + MSDOS_PE_OFFSET_OFFSET);
+    if (pe_offset > size
+        || size - pe_offset < PE_SIGNATURE_SIZE + COFF_HEADER_SIZE
+        || READ_UINT32_LE(data + pe_offset) != PE_SIGNATURE)
+    {
+        return 0;
+    }
+    coff_offset = (size_t) pe_offset + PE_SIGNATURE_SIZE;
+    decode_coff_header(data + coff_offset, &header);
+    view->header_offset = coff_offset;
+    view->machine = header.machine_id;
+    view->byte_order = IMAGE_LITTLE_ENDIAN;
+    view->word_size = header.characteristics & COFF_32_BIT_IMAGE
+        ? 32
+        : get_machine_word_size(header.machine_id);
+    magic_offset = coff_offset + COFF_HEADER_SIZE;
+    if (header.executable_header_size >= 2 && size - magic_offset >= 2)
+    {
+        switch (READ_UINT16_LE(data + magic_offset))
+        {
+        case PE32_MAGIC:
+            view->word_size = 32;
+            break;
+        case PE32_PLUS_MAGIC:
+            view->word_size = 64;
+            break;
+        default:
+            break;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Tests if an image is a bare COFF object file.
+ *
+ * @see image.h for more information.
+ *
+ * @param   data    The first byte of the image.
+ * @param   size    The number of bytes available at `data`.
+ * @param   view    Receives the description of the image.
+ * @return  1 if the image is a COFF object; 0 otherwise.
+ */
+int sniff_coff_object(const uint8_ne* data,
+                      size_t size,
+                      struct image_view* view)
+{
+    struct coff_header header;
+    if (size < COFF_HEADER_SIZE)
+    {
+        return 0;
+    }
+    decode_coff_header(data, &header);
+    if (header.machine_id == COFF_MACH_UNKNOWN
+        || !is_coff_machine_known(header.machine_id)
+        || header.section_count == 0
+        || header.executable_header_size != 0)
+    {
+        return 0;
+    }
+    view->header_offset = 0;
+    view->machine = header.machine_id;
+    view->byte_order = IMAGE_LITTLE_ENDIAN;
+    view->word_size = get_machine_word_size(header.machine_id);
+    return 1;
+}
+
+/**
+ * @brief Decodes the COFF header of a PE or COFF image view.
+ *
+ * @param   view    A view of a PE or COFF image.
+ * @param   header  Receives the decoded COFF header.
+ * @return  1 if the header was decoded; 0 if `view` is not a PE or COFF image.
+ */
+int read_coff_header(const struct image_view* view,
+                     struct coff_header* header)
+{
+    if ((view->format != IMAGE_FORMAT_PE && view->format != IMAGE_FORMAT_COFF)
+        || view->header_offset > view->size
+        || view->size - view->header_offset < COFF_HEADER_SIZE)
+    {
+        return 0;
+    }
+    decode_coff_header(view->data + view->header_offset, header);
+    return 1;
+}
+
+/**
+ * @brief Reads an entry in the data directory of a PE image view.
+ *
+ * @see image.h for more information.
+ *
+ * @param   view        A view of a PE image.
+ * @param   index       The index of the directory; a `PE_DIRECTORY_*` value.
+ * @param   directory   Receives the directory entry.
+ * @return  1 if the entry was read; 0 if the image has no such entry, or it
+ *          lies outside the view.
+ */
+int read_pe_data_directory(const struct image_view* view,
+                           unsigned int index,
+                           struct pe_data_directory* directory)
+{
+    struct coff_header header;
+    const uint8_ne* executable_header;
+    size_t directory_offset;
+    size_t entry_offset;
+    if (view->format != IMAGE_FORMAT_PE || !read_coff_header(view, &header))
+    {
+        return 0;
+    }
+    if (header.executable_header_size < 2
+        || view->size - view->header_offset - COFF_HEADER_SIZE
+            < header.executable_header_size)
+    {
+        return 0;
+    }
+    executable_header = view->data + view->header_offset + COFF_HEADER_SIZE;
+    switch (READ_UINT16_LE(executable_header))
+    {
+    case PE32_MAGIC:
+        directory_offset = PE32_DIRECTORY_OFFSET;
+        break;
+    case PE32_PLUS_MAGIC:
+        directory_offset = PE32_PLUS_DIRECTORY_OFFSET;
+        break;
+    default:
+        return 0;
+    }
+    entry_offset = directory_offset + (size_t) index * PE_DIRECTORY_ENTRY_SIZE;
+    if (entry_offset + PE_DIRECTORY_ENTRY_SIZE > header.executable_header_size
+        || index >= READ_UINT32_LE(executable_header + directory_offset - 4))
+    {
+        return 0;
+    }
+    directory->rva = READ_UINT32_LE(executable_header + entry_offset);
+    directory->size = READ_UINT32_LE(executable_header + entry_offset + 4);
+    return 1;
+}
@@ -13,51 +13,103 @@
  * @date 18/10/2019.
  */
 
+#include <stddef.h>
+
+#include "format/byte_order.h"
 #include "format/pecoff/machines.h"
 #include "platform/types.h"
 
 
 /**
- * @struct machine_string
- * @brief Associates a machine ID with a string name.
+ * @def HOST_MACHINE_CAPS
+ * @brief The `COFF_CAP_*` flags of the machines the host can run natively.
  */
-struct machine_string 
-{
-    uint16_ne id;
-    const char* const name;
-};
+#ifndef HOST_MACHINE_CAPS
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define HOST_MACHINE_CAPS   (COFF_CAP_X86_64 | COFF_CAP_X86)
+#elif defined(__i386__) || defined(_M_IX86)
+#define HOST_MACHINE_CAPS   COFF_CAP_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define HOST_MACHINE_CAPS   COFF_CAP_ARM64
+#elif defined(__arm__) || defined(_M_ARM)
+#define HOST_MACHINE_CAPS   COFF_CAP_ARM
+#elif defined(__ia64__) || defined(_M_IA64)
+#define HOST_MACHINE_CAPS   COFF_CAP_IA64
+#elif defined(__riscv) && defined(__riscv_xlen) && __riscv_xlen == 64
+#define HOST_MACHINE_CAPS   COFF_CAP_RISCV64
+#elif defined(__riscv)
+#define HOST_MACHINE_CAPS   COFF_CAP_RISCV32
+#elif defined(__mips__) && defined(__MIPSEL__)
+#define HOST_MACHINE_CAPS   COFF_CAP_MIPS
+#elif defined(__powerpc__) && defined(__LITTLE_ENDIAN__) \
+    && !defined(__powerpc64__)
+#define HOST_MACHINE_CAPS   COFF_CAP_POWERPC
+#else
+#define HOST_MACHINE_CAPS   0
+#endif
+#endif
+
 
 /**
- * @var machine_strings
- * @brief machine_strings pairs COFF machine IDs with human readable names.
+ * @var machine_infos
+ * @brief machine_infos describes the name and properties of each COFF
+ * machine ID.
+ *
+ * @attention machine_infos is sorted by machine ID, so it can be binary
+ * searched.
  */
-const struct machine_string machine_strings[] = 
+const struct coff_machine_info machine_infos[] =
 {
-    {COFF_MACH_UNKNOWN,      "Unknown/Default (COFF)"},
-    {COFF_MACH_AM33,         "Matsushita AM33 (COFF)"},
-    {COFF_MACH_AMD64,        "x86_64 (COFF)"},
-    {COFF_MACH_ARM,          "ARM32 little endian (COFF)"},
-    {COFF_MACH_ARM64,        "ARM64 little endian (COFF)"},
-    {COFF_MACH_ARMNT,        "ARM Thumb-2 little endian (COFF)"},
-    {COFF_MACH_EBC,          "EFI bytecode (COFF)"},
-    {COFF_MACH_I386,         "x86 (COFF)"},
-    {COFF_MACH_IA64,         "IA64 Itanium (COFF)"},
-    {COFF_MACH_M32R,         "Mitshubishi M32R little endian (COFF)"},
-    {COFF_MACH_MIPS16,       "MIPS16 (COFF)"},
-    {COFF_MACH_MIPSFPU,      "MIPS with FPU (COFF)"},
-    {COFF_MACH_MIPSFPU16,    "MIPS 16-bit with FPU (COFF)"},
-    {COFF_MACH_POWERPC,      "PowerPC (COFF)"},
-    {COFF_MACH_POWERPCFP,    "PowerPC with FPU (COFF)"},
-    {COFF_MACH_MIPSFPU,      "MIPS little endian (COFF)"},
-    {COFF_MACH_RISCV32,      "RISC-V 32-bit (COFF)"},
-    {COFF_MACH_RISCV64,      "RISC-V 64-bit (COFF)"},
-    {COFF_MACH_RISCV128,     "RISC-V 128-bit (COFF)"},
-    {COFF_MACH_SH3,          "Hitachi SH3 (COFF)"},
-    {COFF_MACH_SH3DP,        "Hitachi Sh3 DSP (COFF)"},
-    {COFF_MACH_SH4,          "Hitachi SH4 (COFF)"},
-    {COFF_MACH_SH5,          "Hitachi SH5 (COFF)"},
-    {COFF_MACH_THUMB,        "ARM Thumb (COFF)"},
-    {COFF_MACH_WCEMIPSV2,    "MIPS WCE v2 little endian (COFF)"},
+    {COFF_MACH_UNKNOWN,   0,   IMAGE_LITTLE_ENDIAN, COFF_ISA_NONE,    COFF_CAP_NEUTRAL,
+     "Unknown/Default (COFF)"},
+    {COFF_MACH_I386,      32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_X86,     COFF_CAP_X86,
+     "x86 (COFF)"},
+    {COFF_MACH_MIPS,      32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_MIPS,    COFF_CAP_MIPS,
+     "MIPS little endian (COFF)"},
+    {COFF_MACH_WCEMIPSV2, 32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_MIPS,    COFF_CAP_MIPS,
+     "MIPS WCE v2 little endian (COFF)"},
+    {COFF_MACH_SH3,       32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_SH,      COFF_CAP_SH,
+     "Hitachi SH3 (COFF)"},
+    {COFF_MACH_SH3DP,     32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_SH,      COFF_CAP_SH,
+     "Hitachi Sh3 DSP (COFF)"},
+    {COFF_MACH_SH4,       32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_SH,      COFF_CAP_SH,
+     "Hitachi SH4 (COFF)"},
+    {COFF_MACH_SH5,       64,  IMAGE_LITTLE_ENDIAN, COFF_ISA_SH,      COFF_CAP_SH5,
+     "Hitachi SH5 (COFF)"},
+    {COFF_MACH_ARM,       32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_ARM,     COFF_CAP_ARM,
+     "ARM32 little endian (COFF)"},
+    {COFF_MACH_THUMB,     32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_ARM,     COFF_CAP_ARM,
+     "ARM Thumb (COFF)"},
+    {COFF_MACH_ARMNT,     32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_ARM,     COFF_CAP_ARM,
+     "ARM Thumb-2 little endian (COFF)"},
+    {COFF_MACH_AM33,      32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_AM33,    COFF_CAP_AM33,
+     "Matsushita AM33 (COFF)"},
+    {COFF_MACH_POWERPC,   32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_POWERPC, COFF_CAP_POWERPC,
+     "PowerPC (COFF)"},
+    {COFF_MACH_POWERPCFP, 32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_POWERPC, COFF_CAP_POWERPC,
+     "PowerPC with FPU (COFF)"},
+    {COFF_MACH_IA64,      64,  IMAGE_LITTLE_ENDIAN, COFF_ISA_IA64,    COFF_CAP_IA64,
+     "IA64 Itanium (COFF)"},
+    {COFF_MACH_MIPS16,    32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_MIPS,    COFF_CAP_MIPS,
+     "MIPS16 (COFF)"},
+    {COFF_MACH_MIPSFPU,   32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_MIPS,    COFF_CAP_MIPS,
+     "MIPS with FPU (COFF)"},
+    {COFF_MACH_MIPSFPU16, 32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_MIPS,    COFF_CAP_MIPS,
+     "MIPS 16-bit with FPU (COFF)"},
+    {COFF_MACH_EBC,       64,  IMAGE_LITTLE_ENDIAN, COFF_ISA_EBC,     COFF_CAP_EBC,
+     "EFI bytecode (COFF)"},
+    {COFF_MACH_RISCV32,   32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_RISCV,   COFF_CAP_RISCV32,
+     "RISC-V 32-bit (COFF)"},
+    {COFF_MACH_RISCV64,   64,  IMAGE_LITTLE_ENDIAN, COFF_ISA_RISCV,   COFF_CAP_RISCV64,
+     "RISC-V 64-bit (COFF)"},
+    {COFF_MACH_RISCV128,  128, IMAGE_LITTLE_ENDIAN, COFF_ISA_RISCV,   COFF_CAP_RISCV128,
+     "RISC-V 128-bit (COFF)"},
+    {COFF_MACH_AMD64,     64,  IMAGE_LITTLE_ENDIAN, COFF_ISA_X86,     COFF_CAP_X86_64,
+     "x86_64 (COFF)"},
+    {COFF_MACH_M32R,      32,  IMAGE_LITTLE_ENDIAN, COFF_ISA_M32R,    COFF_CAP_M32R,
+     "Mitshubishi M32R little endian (COFF)"},
+    {COFF_MACH_ARM64,     64,  IMAGE_LITTLE_ENDIAN, COFF_ISA_ARM,     COFF_CAP_ARM64,
+     "ARM64 little endian (COFF)"},
 };
 
 /**
@@ -69,17 +121,8 @@ const struct machine_string machine_strings[] =
 const char* get_coff_machine_name(uint16_ne machine_id)
 {
     static const char* const unrecognised_machine = "Unrecognised (COFF)";
-    unsigned int i;
-    for (i = 0;
-         i < sizeof(machine_strings) / sizeof(struct machine_string);
-         i++) 
-    {
-        if (machine_strings[i].id == machine_id) 
-        {
-            return machine_strings[i].name;
-        }
-    }
-    return unrecognised_machine;
+    const struct coff_machine_info* info = get_coff_machine_info(machine_id);
+    return info != NULL ? info->name : unrecognised_machine;
 }
 
 /**
@@ -95,15 +138,60 @@ const char* get_coff_machine_name(uint16_ne machine_id)
  */
 int is_coff_machine_known(uint16_ne machine_id)
 {
-    unsigned int i;
-    for (i = 0;
-         i < sizeof(machine_strings) / sizeof(struct machine_string);
-         i++)
+    return get_coff_machine_info(machine_id) != NULL;
+}
+
+/**
+ * @brief Describes the properties of a machine ID.
+ *
+ * @param   machine_id  The COFF machine ID.
+ * @return  A pointer to the machine's description, or NULL if the machine ID
+ *          is unknown.
+ */
+const struct coff_machine_info* get_coff_machine_info(uint16_ne machine_id)
+{
+    size_t low = 0;
+    size_t high = sizeof(machine_infos) / sizeof(struct coff_machine_info);
+    while (low < high)
     {
-        if (machine_strings[i].id == machine_id) 
+        size_t middle = low + (high - low) / 2;
+        if (machine_infos[middle].id == machine_id)
         {
-            return 1;
+            return &machine_infos[middle];
+        }
+        if (machine_infos[middle].id < machine_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
         }
     }
-    return 0;
+    return NULL;
+}
+
+/**
+ * @brief Lists the properties of every known machine ID.
+ *
+ * @param   count   Receives the number of machines listed.
+ * @return  A pointer to the first machine's description. The descriptions
+ *          are sorted by machine ID.
+ */
+const struct coff_machine_info* list_coff_machines(size_t* count)
+{
+    *count = sizeof(machine_infos) / sizeof(struct coff_machine_info);
+    return machine_infos;
+}
+
+/**
+ * @brief Returns the capabilities of the host Prim was compiled for.
+ *
+ * @see machines.h for more information.
+ *
+ * @return  The host's `COFF_CAP_*` flags.
+ */
+uint32_ne get_host_machine_caps(void)
+{
+    return (uint32_ne) (HOST_MACHINE_CAPS | COFF_CAP_NEUTRAL);
 }
@@ -0,0 +1,1020 @@
+/**
+ * @file object.c
+ * @brief Loads and links COFF object files in memory.
+ *
+ * object.c lays out an object's sections, resolves its symbols in one pass,
+ * then applies each section's relocation table in a loop specialised for the
+ * object's machine.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <string.h>
+
+#include "format/format.h"
+#include "format/pecoff/coff.h"
+#include "format/pecoff/image.h"
+#include "format/pecoff/machines.h"
+#include "format/pecoff/object.h"
+#include "format/pecoff/section.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @def SYMBOL_SIZE
+ * @brief The size of a symbol table record, in bytes.
+ */
+#define SYMBOL_SIZE                 18
+
+/**
+ * @def SYMBOL_SHORT_NAME_SIZE
+ * @brief The size of the name field in a symbol table record, in bytes.
+ */
+#define SYMBOL_SHORT_NAME_SIZE      8
+
+/**
+ * @def RELOCATION_SIZE
+ * @brief The size of a relocation table entry, in bytes.
+ */
+#define RELOCATION_SIZE             10
+
+/**
+ * @def DEFAULT_SECTION_ALIGNMENT
+ * @brief The alignment of object sections which do not specify one.
+ */
+#define DEFAULT_SECTION_ALIGNMENT   16
+
+/**
+ * @def UNLOADED_SECTION
+ * @brief The characteristics of sections which are not loaded.
+ */
+#define UNLOADED_SECTION \
+    (SECTION_LINK_INFO | SECTION_LINK_REMOVE | SECTION_DISCARDABLE)
+
+/**
+ * @def STUB_SIZE
+ * @brief The size of a branch stub, in bytes.
+ *
+ * A stub is a `jmp [rip+0]` instruction, followed by the 64-bit address it
+ * jumps to, padded with `int3` to keep stubs aligned.
+ */
+#define STUB_SIZE                   16
+
+/**
+ * @def STUB_ALIGNMENT
+ * @brief The alignment of the stub area, in bytes.
+ */
+#define STUB_ALIGNMENT              16
+
+/**
+ * @def MAXIMUM_SIZE
+ * @brief The largest value a `size_t` can hold.
+ */
+#define MAXIMUM_SIZE                ((size_t) -1)
+
+/**
+ * @def SIGN_EXTEND_32
+ * @brief Sign extends a 32-bit value to a 64-bit unsigned integer.
+ */
+#define SIGN_EXTEND_32(value) \
+    ((((uint64_ne) (value)) ^ 0x80000000) - 0x80000000)
+
+/**
+ * @struct object_layout
+ * @brief Places an object's sections and branch stubs in memory.
+ *
+ * `COFF_MACH_AMD64` objects get one branch stub per undefined external
+ * symbol, after the sections, so calls to symbols more than 2 GiB away can
+ * still be reached with a 32-bit displacement. The stubs are followed by a
+ * table of their symbols' indices, in ascending order.
+ */
+struct object_layout
+{
+    size_t size;
+    size_t alignment;
+    size_t stub_offset;
+    uint32_ne stub_count;
+};
+
+/**
+ * @struct relocation_batch
+ * @brief The relocation table of one loaded section.
+ */
+struct relocation_batch
+{
+    const struct coff_object* object;
+    const struct coff_link* link;
+    const struct object_layout* layout;
+    uint8_ne* memory;
+    uint64_ne address;
+    uint32_ne size;
+    uint32_ne characteristics;
+    uint32_ne base_rva;
+    const uint8_ne* relocations;
+    uint32_ne count;
+};
+
+/**
+ * @brief Gets the alignment of an object's section.
+ *
+ * @param   characteristics The section's characteristics.
+ * @return  The section's alignment, in bytes.
+ */
+static size_t get_section_alignment(uint32_ne characteristics)
+{
+    uint32_ne field
+        = (characteristics & SECTION_ALIGN_MASK) >> SECTION_ALIGN_SHIFT;
+    if (field == 0 || field > 14)
+    {
+        return DEFAULT_SECTION_ALIGNMENT;
+    }
+    return (size_t) 1 << (field - 1);
+}
+
+/**
+ * @brief Finds the field a relocation patches.
+ *
+ * @param   batch   The relocation table being applied.
+ * @param   offset  The offset of the field in the section.
+ * @param   size    The size of the field, in bytes.
+ * @return  A pointer to the field, or NULL if it lies outside the section.
+ */
+static uint8_ne* get_field(const struct relocation_batch* batch,
+                           uint32_ne offset,
+                           uint32_ne size)
+{
+    if (offset > batch->size || batch->size - offset < size)
+    {
+        return NULL;
+    }
+    return batch->memory + offset;
+}
+
+/**
+ * @brief Gets the resolved address and section of a relocation's symbol.
+ *
+ * @param   batch           The relocation table being applied.
+ * @param   index           The symbol table index of the symbol.
+ * @param   address         Receives the symbol's address.
+ * @param   section_number  Receives the symbol's section number.
+ * @return  1 if the symbol is resolved; 0 otherwise.
+ */
+static int get_target(const struct relocation_batch* batch,
+                      uint32_ne index,
+                      uint64_ne* address,
+                      uint16_ne* section_number)
+{
+    if (index >= batch->object->header.symbol_count)
+    {
+        return 0;
+    }
+    *address = batch->link->symbol_addresses[index];
+    *section_number = READ_UINT16_LE(batch->object->symbols
+                                     + (size_t) index * SYMBOL_SIZE
+                                     + 12);
+    return *address != COFF_UNRESOLVED_ADDRESS;
+}
+
+/**
+ * @brief Adds a 32-bit absolute address to a field.
+ *
+ * @param   field   The field to patch, or NULL if it is out of range.
+ * @param   target  The address of the relocation's symbol.
+ * @return  1 if the field was patched; 0 otherwise.
+ */
+static int apply_addr32(uint8_ne* field, uint64_ne target)
+{
+    uint64_ne value;
+    if (field == NULL)
+    {
+        return 0;
+    }
+    value = READ_UINT32_LE(field) + target;
+    if (value > 0xffffffff)
+    {
+        return 0;
+    }
+    WRITE_UINT32_LE(field, value);
+    return 1;
+}
+
+/**
+ * @brief Adds a 32-bit address relative to the load address to a field.
+ *
+ * @param   field           The field to patch, or NULL if it is out of range.
+ * @param   target          The address of the relocation's symbol.
+ * @param   load_address    The address the object is loaded at.
+ * @return  1 if the field was patched; 0 otherwise.
+ */
+static int apply_addr32nb(uint8_ne* field,
+                          uint64_ne target,
+                          uint64_ne load_address)
+{
+    uint64_ne value;
+    if (field == NULL)
+    {
+        return 0;
+    }
+    value = READ_UINT32_LE(field) + target - load_address;
+    if (value > 0xffffffff)
+    {
+        return 0;
+    }
+    WRITE_UINT32_LE(field, value);
+    return 1;
+}
+
+/**
+ * @brief Adds a 32-bit displacement from the end of an instruction to a
+ * field.
+ *
+ * @param   field   The field to patch, or NULL if it is out of range.
+ * @param   target  The address the displacement reaches.
+ * @param   next    The address the displacement is relative to.
+ * @return  1 if the field was patched; 0 otherwise.
+ */
+static int apply_rel32(uint8_ne* field, uint64_ne target, uint64_ne next)
+{
+    uint64_ne value;
+    if (field == NULL)
+    {
+        return 0;
+    }
+    value = SIGN_EXTEND_32(READ_UINT32_LE(field)) + target - next;
+    if (value + 0x80000000 > 0xffffffff)
+    {
+        return 0;
+    }
+    WRITE_UINT32_LE(field, value & 0xffffffff);
+    return 1;
+}
+
+/**
+ * @brief Finds the branch stub a REL32 relocation can use instead of its
+ * symbol.
+ *
+ * Only calls and jumps with no addend, in code sections, are redirected: the
+ * stub is entered in place of the symbol, so any other reference would read
+ * the stub rather than the symbol's data.
+ *
+ * @param   batch   The relocation table being applied.
+ * @param   index   The symbol table index of the relocation's symbol.
+ * @param   field   The field to patch, or NULL if it is out of range.
+ * @param   stub    Receives the address of the symbol's stub.
+ * @return  1 if the relocation can use a stub; 0 otherwise.
+ */
+static int find_stub(const struct relocation_batch* batch,
+                     uint32_ne index,
+                     const uint8_ne* field,
+                     uint64_ne* stub)
+{
+    const struct object_layout* layout = batch->layout;
+    const uint8_ne* indices;
+    uint32_ne low = 0;
+    uint32_ne high = layout->stub_count;
+    if (!(batch->characteristics & (SECTION_CODE | SECTION_EXECUTE))
+        || field == NULL
+        || field == batch->memory
+        || READ_UINT32_LE(field) != 0)
+    {
+        return 0;
+    }
+    if (field[-1] != 0xe8
+        && field[-1] != 0xe9
+        && (field - batch->memory < 2
+            || field[-2] != 0x0f
+            || (field[-1] & 0xf0) != 0x80))
+    {
+        return 0;
+    }
+    indices = batch->link->memory
+        + layout->stub_offset
+        + (size_t) layout->stub_count * STUB_SIZE;
+    while (low < high)
+    {
+        uint32_ne middle = low + (high - low) / 2;
+        uint32_ne candidate = READ_UINT32_LE(indices + (size_t) middle * 4);
+        if (candidate == index)
+        {
+            *stub = batch->link->load_address
+                + layout->stub_offset
+                + (size_t) middle * STUB_SIZE;
+            return 1;
+        }
+        if (candidate < index)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes a symbol's 16-bit section number to a field.
+ *
+ * @param   field           The field to patch, or NULL if it is out of range.
+ * @param   section_number  The section number of the relocation's symbol.
+ * @return  1 if the field was patched; 0 otherwise.
+ */
+static int apply_section(uint8_ne* field, uint16_ne section_number)
+{
+    if (field == NULL)
+    {
+        return 0;
+    }
+    WRITE_UINT16_LE(field, section_number);
+    return 1;
+}
+
+/**
+ * @brief Adds a 32-bit offset from the start of the symbol's section to a
+ * field.
+ *
+ * @param   batch           The relocation table being applied.
+ * @param   field           The field to patch, or NULL if it is out of range.
+ * @param   target          The address of the relocation's symbol.
+ * @param   section_number  The section number of the relocation's symbol.
+ * @return  1 if the field was patched; 0 otherwise.
+ */
+static int apply_secrel(const struct relocation_batch* batch,
+                        uint8_ne* field,
+                        uint64_ne target,
+                        uint16_ne section_number)
+{
+    uint64_ne value;
+    if (field == NULL
+        || section_number == 0
+        || section_number > batch->object->header.section_count)
+    {
+        return 0;
+    }
+    value = READ_UINT32_LE(field)
+        + target
+        - batch->link->section_addresses[section_number - 1];
+    if (value > 0xffffffff)
+    {
+        return 0;
+    }
+    WRITE_UINT32_LE(field, value);
+    return 1;
+}
+
+/**
+ * @brief Applies a section's relocation table for a `COFF_MACH_AMD64`
+ * object.
+ *
+ * @param   batch   The relocation table to apply.
+ * @return  1 if every relocation was applied; 0 otherwise.
+ */
+static int relocate_amd64(const struct relocation_batch* batch)
+{
+    const uint8_ne* relocation = batch->relocations;
+    uint32_ne i;
+    for (i = 0; i < batch->count; i++, relocation += RELOCATION_SIZE)
+    {
+        uint32_ne offset = READ_UINT32_LE(relocation) - batch->base_rva;
+        uint32_ne index = READ_UINT32_LE(relocation + 4);
+        uint16_ne type = READ_UINT16_LE(relocation + 8);
+        uint16_ne section_number;
+        uint64_ne target;
+        uint64_ne stub;
+        uint8_ne* field;
+        int applied;
+        if (type == COFF_REL_AMD64_ABSOLUTE)
+        {
+            continue;
+        }
+        if (!get_target(batch, index, &target, &section_number))
+        {
+            return 0;
+        }
+        switch (type)
+        {
+        case COFF_REL_AMD64_ADDR64:
+            field = get_field(batch, offset, 8);
+            applied = field != NULL;
+            if (applied)
+            {
+                target += READ_UINT64_LE(field);
+                WRITE_UINT64_LE(field, target);
+            }
+            break;
+        case COFF_REL_AMD64_ADDR32:
+            applied = apply_addr32(get_field(batch, offset, 4), target);
+            break;
+        case COFF_REL_AMD64_ADDR32NB:
+            applied = apply_addr32nb(get_field(batch, offset, 4),
+                                     target,
+                                     batch->link->load_address);
+            break;
+        case COFF_REL_AMD64_REL32:
+            field = get_field(batch, offset, 4);
+            applied = apply_rel32(field, target, batch->address + offset + 4)
+                || (find_stub(batch, index, field, &stub)
+                    && apply_rel32(field,
+                                   stub,
+                                   batch->address + offset + 4));
+            break;
+        case COFF_REL_AMD64_REL32_1:
+        case COFF_REL_AMD64_REL32_2:
+        case COFF_REL_AMD64_REL32_3:
+        case COFF_REL_AMD64_REL32_4:
+        case COFF_REL_AMD64_REL32_5:
+            applied = apply_rel32(get_field(batch, offset, 4),
+                                  target,
+                                  batch->address
+                                      + offset
+                                      + 4
+                                      + (type - COFF_REL_AMD64_REL32));
+            break;
+        case COFF_REL_AMD64_SECTION:
+            applied = apply_section(get_field(batch, offset, 2),
+                                    section_number);
+            break;
+        case COFF_REL_AMD64_SECREL:
+            applied = apply_secrel(batch,
+                                   get_field(batch, offset, 4),
+                                   target,
+                                   section_number);
+            break;
+        default:
+            applied = 0;
+            break;
+        }
+        if (!applied)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Applies a section's relocation table for a `COFF_MACH_I386`
+ * object.
+ *
+ * @param   batch   The relocation table to apply.
+ * @return  1 if every relocation was applied; 0 otherwise.
+ */
+static int relocate_i386(const struct relocation_batch* batch)
+{
+    const uint8_ne* relocation = batch->relocations;
+    uint32_ne i;
+    for (i = 0; i < batch->count; i++, relocation += RELOCATION_SIZE)
+    {
+        uint32_ne offset = READ_UINT32_LE(relocation) - batch->base_rva;
+        uint16_ne type = READ_UINT16_LE(relocation + 8);
+        uint16_ne section_number;
+        uint64_ne target;
+        int applied;
+        if (type == COFF_REL_I386_ABSOLUTE)
+        {
+            continue;
+        }
+        if (!get_target(batch,
+                        READ_UINT32_LE(relocation + 4),
+                        &target,
+                        &section_number))
+        {
+            return 0;
+        }
+        switch (type)
+        {
+        case COFF_REL_I386_DIR32:
+            applied = apply_addr32(get_field(batch, offset, 4), target);
+            break;
+        case COFF_REL_I386_DIR32NB:
+            applied = apply_addr32nb(get_field(batch, offset, 4),
+                                     target,
+                                     batch->link->load_address);
+            break;
+        case COFF_REL_I386_REL32:
+            applied = apply_rel32(get_field(batch, offset, 4),
+                                  target,
+                                  batch->address + offset + 4);
+            break;
+        case COFF_REL_I386_SECTION:
+            applied = apply_section(get_field(batch, offset, 2),
+                                    section_number);
+            break;
+        case COFF_REL_I386_SECREL:
+            applied = apply_secrel(batch,
+                                   get_field(batch, offset, 4),
+                                   target,
+                                   section_number);
+            break;
+        default:
+            applied = 0;
+            break;
+        }
+        if (!applied)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Indicates if a symbol table record needs a branch stub.
+ *
+ * @param   record  A symbol table record.
+ * @return  1 if the record is an undefined external symbol; 0 otherwise.
+ */
+static int is_stubbed_symbol(const uint8_ne* record)
+{
+    return READ_UINT16_LE(record + 12) == COFF_SYMBOL_UNDEFINED
+        && READ_UINT32_LE(record + 8) == 0
+        && (record[16] == COFF_CLASS_EXTERNAL
+            || record[16] == COFF_CLASS_WEAK_EXTERNAL);
+}
+
+/**
+ * @brief Places an object's sections and branch stubs in memory.
+ *
+ * @param   object  An open COFF object.
+ * @param   layout  Receives the layout.
+ * @return  1 if the layout was calculated; 0 if a section header could not
+ *          be read, or the size does not fit in a `size_t`.
+ */
+static int plan_coff_object(const struct coff_object* object,
+                            struct object_layout* layout)
+{
+    struct section_header section;
+    const uint8_ne* record = NULL;
+    size_t padding;
+    uint32_ne i;
+    layout->size = 0;
+    layout->alignment = 1;
+    layout->stub_count = 0;
+    for (i = 0; i < object->header.section_count; i++)
+    {
+        size_t section_alignment;
+        if (!read_section_header(object->view, i, &section))
+        {
+            return 0;
+        }
+        if (section.characteristics & UNLOADED_SECTION)
+        {
+            continue;
+        }
+        section_alignment = get_section_alignment(section.characteristics);
+        padding = (section_alignment - layout->size % section_alignment)
+            % section_alignment;
+        if (padding > MAXIMUM_SIZE - layout->size
+            || section.raw_data_size > MAXIMUM_SIZE - layout->size - padding)
+        {
+            return 0;
+        }
+        layout->size += padding + section.raw_data_size;
+        if (section_alignment > layout->alignment)
+        {
+            layout->alignment = section_alignment;
+        }
+    }
+    layout->stub_offset = layout->size;
+    if (object->header.machine_id != COFF_MACH_AMD64)
+    {
+        return 1;
+    }
+    for (i = 0; i < object->header.symbol_count; i += 1 + record[17])
+    {
+        record = object->symbols + (size_t) i * SYMBOL_SIZE;
+        layout->stub_count += is_stubbed_symbol(record);
+    }
+    if (layout->stub_count == 0)
+    {
+        return 1;
+    }
+    padding = (STUB_ALIGNMENT - layout->size % STUB_ALIGNMENT)
+        % STUB_ALIGNMENT;
+    if (padding > MAXIMUM_SIZE - layout->size
+        || layout->stub_count
+            > (MAXIMUM_SIZE - layout->size - padding) / (STUB_SIZE + 4))
+    {
+        return 0;
+    }
+    layout->stub_offset = layout->size + padding;
+    layout->size = layout->stub_offset
+        + (size_t) layout->stub_count * (STUB_SIZE + 4);
+    if (STUB_ALIGNMENT > layout->alignment)
+    {
+        layout->alignment = STUB_ALIGNMENT;
+    }
+    return 1;
+}
+
+/**
+ * @brief Writes a branch stub for each undefined external symbol.
+ *
+ * @param   object  An open COFF object.
+ * @param   link    The link in progress, with symbols resolved.
+ * @param   layout  The object's layout.
+ */
+static void write_stubs(const struct coff_object* object,
+                        const struct coff_link* link,
+                        const struct object_layout* layout)
+{
+    uint8_ne* stub = link->memory + layout->stub_offset;
+    uint8_ne* index = stub + (size_t) layout->stub_count * STUB_SIZE;
+    const uint8_ne* record = NULL;
+    uint32_ne i;
+    for (i = 0; i < object->header.symbol_count; i += 1 + record[17])
+    {
+        record = object->symbols + (size_t) i * SYMBOL_SIZE;
+        if (!is_stubbed_symbol(record))
+        {
+            continue;
+        }
+        stub[0] = 0xff;
+        stub[1] = 0x25;
+        WRITE_UINT32_LE(stub + 2, 0);
+        WRITE_UINT64_LE(stub + 6, link->symbol_addresses[i]);
+        stub[14] = 0xcc;
+        stub[15] = 0xcc;
+        WRITE_UINT32_LE(index, i);
+        stub += STUB_SIZE;
+        index += 4;
+    }
+}
+
+/**
+ * @brief Finds the address of a single symbol.
+ *
+ * @param   object  An open COFF object.
+ * @param   link    The link in progress, with section addresses assigned.
+ * @param   symbol  The symbol to resolve.
+ * @return  The symbol's address, or `COFF_UNRESOLVED_ADDRESS`.
+ */
+static uint64_ne resolve_symbol(const struct coff_object* object,
+                                const struct coff_link* link,
+                                const struct coff_symbol* symbol)
+{
+    struct section_header section;
+    uint64_ne address;
+    if (symbol->section_number > 0)
+    {
+        if (!read_section_header(object->view,
+                                 symbol->section_number - 1,
+                                 &section)
+            || section.characteristics & UNLOADED_SECTION)
+        {
+            return COFF_UNRESOLVED_ADDRESS;
+        }
+        return link->section_addresses[symbol->section_number - 1]
+            + symbol->value;
+    }
+    if (symbol->section_number == COFF_SYMBOL_ABSOLUTE)
+    {
+        return symbol->value;
+    }
+    if (symbol->section_number == COFF_SYMBOL_UNDEFINED
+        && (symbol->storage_class == COFF_CLASS_EXTERNAL
+            || symbol->storage_class == COFF_CLASS_WEAK_EXTERNAL)
+        && link->resolve != NULL
+        && link->resolve(link->context,
+                         symbol->name,
+                         symbol->name_length,
+                         &address))
+    {
+        return address;
+    }
+    return COFF_UNRESOLVED_ADDRESS;
+}
+
+/**
+ * @brief Resolves every symbol in an object, in one pass over the symbol
+ * table.
+ *
+ * Unresolved weak externals then take the address of their default symbol,
+ * which may appear later in the table.
+ *
+ * @param   object  An open COFF object.
+ * @param   link    The link in progress, with section addresses assigned.
+ * @return  1 if the symbol table was read; 0 if it is malformed.
+ */
+static int resolve_symbols(const struct coff_object* object,
+                           const struct coff_link* link)
+{
+    uint32_ne count = object->header.symbol_count;
+    int weak_pending = 0;
+    uint32_ne i;
+    uint32_ne j;
+    for (i = 0; i < count; i += 1 + j)
+    {
+        struct coff_symbol symbol;
+        if (!read_coff_symbol(object, i, &symbol))
+        {
+            return 0;
+        }
+        link->symbol_addresses[i] = resolve_symbol(object, link, &symbol);
+        weak_pending |= link->symbol_addresses[i] == COFF_UNRESOLVED_ADDRESS
+            && symbol.storage_class == COFF_CLASS_WEAK_EXTERNAL;
+        for (j = 0; j < symbol.auxiliary_count && i + 1 + j < count; j++)
+        {
+            link->symbol_addresses[i + 1 + j] = 0;
+        }
+    }
+    for (i = 0; weak_pending && i < count; i += 1 + j)
+    {
+        const uint8_ne* record = object->symbols + (size_t) i * SYMBOL_SIZE;
+        j = record[17];
+        if (record[16] == COFF_CLASS_WEAK_EXTERNAL
+            && link->symbol_addresses[i] == COFF_UNRESOLVED_ADDRESS
+            && j > 0
+            && i + 1 < count)
+        {
+            uint32_ne tag = READ_UINT32_LE(record + SYMBOL_SIZE);
+            if (tag < count)
+            {
+                link->symbol_addresses[i] = link->symbol_addresses[tag];
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Applies the relocation table of one loaded section.
+ *
+ * @param   object          An open COFF object.
+ * @param   link            The link in progress, with symbols resolved.
+ * @param   layout          The object's layout.
+ * @param   section         The section's header.
+ * @param   section_index   The zero based index of the section.
+ * @return  1 if every relocation was applied; 0 otherwise.
+ */
+static int relocate_section(const struct coff_object* object,
+                            const struct coff_link* link,
+                            const struct object_layout* layout,
+                            const struct section_header* section,
+                            unsigned int section_index)
+{
+    const struct image_view* view = object->view;
+    struct relocation_batch batch;
+    if (section->relocation_count == 0)
+    {
+        return 1;
+    }
+    batch.object = object;
+    batch.link = link;
+    batch.layout = layout;
+    batch.address = link->section_addresses[section_index];
+    batch.memory = link->memory + (size_t) (batch.address - link->load_address);
+    batch.size = section->raw_data_size;
+    batch.characteristics = section->characteristics;
+    batch.base_rva = section->virtual_address;
+    batch.count = section->relocation_count;
+    if (section->relocations_offset > view->size
+        || (view->size - section->relocations_offset) / RELOCATION_SIZE
+            < batch.count)
+    {
+        return 0;
+    }
+    batch.relocations = view->data + section->relocations_offset;
+    if (section->characteristics & SECTION_EXTENDED_RELOCATIONS
+        && batch.count == 0xffff)
+    {
+        batch.count = READ_UINT32_LE(batch.relocations);
+        if (batch.count == 0
+            || (view->size - section->relocations_offset) / RELOCATION_SIZE
+                < batch.count)
+        {
+            return 0;
+        }
+        batch.relocations += RELOCATION_SIZE;
+        batch.count--;
+    }
+    switch (object->header.machine_id)
+    {
+    case COFF_MACH_AMD64:
+        return relocate_amd64(&batch);
+    case COFF_MACH_I386:
+        return relocate_i386(&batch);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Indicates if relocations are supported for a machine.
+ *
+ * @param   machine_id  A `COFF_MACH_*` machine ID.
+ * @return  1 if objects for the machine can be linked; 0 otherwise.
+ */
+static int is_coff_machine_linkable(uint16_ne machine_id)
+{
+    return machine_id == COFF_MACH_AMD64 || machine_id == COFF_MACH_I386;
+}
+
+/**
+ * @brief Opens a COFF object file.
+ *
+ * @see object.h for more information.
+ *
+ * @param   object  Receives the open object.
+ * @param   view    A view of a COFF object file.
+ * @return  1 if the object was opened; 0 if `view` is not a COFF object, or
+ *          its symbol or string table lies outside the view.
+ */
+int open_coff_object(struct coff_object* object,
+                     const struct image_view* view)
+{
+    size_t offset;
+    if (view->format != IMAGE_FORMAT_COFF
+        || !read_coff_header(view, &object->header))
+    {
+        return 0;
+    }
+    object->view = view;
+    object->symbols = NULL;
+    object->strings = NULL;
+    object->strings_size = 0;
+    if (object->header.symbol_count == 0)
+    {
+        return 1;
+    }
+    offset = object->header.symbol_table_offset;
+    if (offset > view->size
+        || (view->size - offset) / SYMBOL_SIZE < object->header.symbol_count)
+    {
+        return 0;
+    }
+    object->symbols = view->data + offset;
+    offset += (size_t) object->header.symbol_count * SYMBOL_SIZE;
+    if (view->size - offset >= 4)
+    {
+        object->strings = view->data + offset;
+        object->strings_size = READ_UINT32_LE(object->strings);
+        if (object->strings_size < 4
+            || view->size - offset < object->strings_size)
+        {
+            object->strings = NULL;
+            object->strings_size = 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Reads an entry from a COFF object's symbol table.
+ *
+ * @see object.h for more information.
+ *
+ * @param   object  An open COFF object.
+ * @param   index   The zero based index of the symbol table record.
+ * @param   symbol  Receives the symbol.
+ * @return  1 if the symbol was read; 0 if `index` is out of range, or the
+ *          symbol's name lies outside the string table.
+ */
+int read_coff_symbol(const struct coff_object* object,
+                     uint32_ne index,
+                     struct coff_symbol* symbol)
+{
+    const uint8_ne* record;
+    const void* end;
+    uint16_ne section_number;
+    if (index >= object->header.symbol_count)
+    {
+        return 0;
+    }
+    record = object->symbols + (size_t) index * SYMBOL_SIZE;
+    if (READ_UINT32_LE(record) == 0)
+    {
+        uint32_ne offset = READ_UINT32_LE(record + 4);
+        if (offset < 4 || offset >= object->strings_size)
+        {
+            return 0;
+        }
+        symbol->name = (const char*) object->strings + offset;
+        end = memchr(symbol->name, 0, object->strings_size - offset);
+        symbol->name_length = end != NULL
+            ? (size_t) ((const char*) end - symbol->name)
+            : object->strings_size - offset;
+    }
+    else
+    {
+        symbol->name = (const char*) record;
+        end = memchr(symbol->name, 0, SYMBOL_SHORT_NAME_SIZE);
+        symbol->name_length = end != NULL
+            ? (size_t) ((const char*) end - symbol->name)
+            : SYMBOL_SHORT_NAME_SIZE;
+    }
+    symbol->value = READ_UINT32_LE(record + 8);
+    section_number = READ_UINT16_LE(record + 12);
+    symbol->section_number = (int16_ne) (section_number & 0x8000
+        ? (long) section_number - 0x10000
+        : (long) section_number);
+    symbol->type = READ_UINT16_LE(record + 14);
+    symbol->storage_class = record[16];
+    symbol->auxiliary_count = record[17];
+    return 1;
+}
+
+/**
+ * @brief Calculates the memory needed to load a COFF object.
+ *
+ * @see object.h for more information.
+ *
+ * @param   object      An open COFF object.
+ * @param   size        Receives the size of the buffer needed, in bytes.
+ * @param   alignment   Receives the alignment the buffer's load address
+ *                      needs, in bytes.
+ * @return  1 if the layout was calculated; 0 if a section header could not
+ *          be read, or the size does not fit in a `size_t`.
+ */
+int get_coff_object_layout(const struct coff_object* object,
+                           size_t* size,
+                           size_t* alignment)
+{
+    struct object_layout layout;
+    if (!plan_coff_object(object, &layout))
+    {
+        return 0;
+    }
+    *size = layout.size;
+    *alignment = layout.alignment;
+    return 1;
+}
+
+/**
+ * @brief Loads a COFF object into memory and applies its relocations.
+ *
+ * @see object.h for more information.
+ *
+ * @param   object  An open COFF object.
+ * @param   link    Describes where the object is loaded, and how external
+ *                  symbols are resolved.
+ * @return  1 if the object was loaded and linked; 0 if the buffer is too
+ *          small or misaligned, a referenced symbol could not be resolved,
+ *          a relocation is unsupported or overflows, or the object is
+ *          malformed.
+ */
+int link_coff_object(const struct coff_object* object,
+                     const struct coff_link* link)
+{
+    const struct image_view* view = object->view;
+    struct section_header section;
+    struct object_layout layout;
+    size_t offset = 0;
+    unsigned int i;
+    if (!is_coff_machine_linkable(object->header.machine_id)
+        || !plan_coff_object(object, &layout)
+        || layout.size > link->memory_size
+        || link->load_address % layout.alignment != 0)
+    {
+        return 0;
+    }
+    memset(link->memory, 0, layout.size);
+    for (i = 0; i < object->header.section_count; i++)
+    {
+        size_t section_alignment;
+        link->section_addresses[i] = COFF_UNRESOLVED_ADDRESS;
+        read_section_header(view, i, &section);
+        if (section.characteristics & UNLOADED_SECTION)
+        {
+            continue;
+        }
+        section_alignment = get_section_alignment(section.characteristics);
+        offset = (offset + section_alignment - 1) & ~(section_alignment - 1);
+        link->section_addresses[i] = link->load_address + offset;
+        if (!(section.characteristics & SECTION_UNINITIALISED_DATA)
+            && section.raw_data_offset != 0)
+        {
+            if (section.raw_data_offset > view->size
+                || view->size - section.raw_data_offset
+                    < section.raw_data_size)
+            {
+                return 0;
+            }
+            memcpy(link->memory + offset,
+                   view->data + section.raw_data_offset,
+                   section.raw_data_size);
+        }
+        offset += section.raw_data_size;
+    }
+    if (!resolve_symbols(object, link))
+    {
+        return 0;
+    }
+    write_stubs(object, link, &layout);
+    for (i = 0; i < object->header.section_count; i++)
+    {
+        read_section_header(view, i, &section);
+        if (!(section.characteristics & UNLOADED_SECTION)
+            && !relocate_section(object, link, &layout, &section, i))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,598 @@
+/**
+ * @file resource.c
+ * @brief Looks up resources in the resource tree of a PE image.
+ *
+ * resource.c searches resource directories in place, without building any
+ * copy of the tree.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+
+#include "format/format.h"
+#include "format/pecoff/image.h"
+#include "format/pecoff/resource.h"
+#include "format/pecoff/section.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @def RESOURCE_DIRECTORY_SIZE
+ * @brief The size of a resource directory table, excluding its entries.
+ */
+#define RESOURCE_DIRECTORY_SIZE     16
+
+/**
+ * @def RESOURCE_ENTRY_SIZE
+ * @brief The size of a resource directory entry, in bytes.
+ */
+#define RESOURCE_ENTRY_SIZE         8
+
+/**
+ * @def RESOURCE_DATA_ENTRY_SIZE
+ * @brief The size of a resource data entry, in bytes.
+ */
+#define RESOURCE_DATA_ENTRY_SIZE    16
+
+/**
+ * @def RESOURCE_HIGH_BIT
+ * @brief Marks string names, and entries naming subdirectories.
+ */
+#define RESOURCE_HIGH_BIT           0x80000000
+
+/**
+ * @def FOLD_UNIT
+ * @brief Folds ASCII letters in a UTF-16 code unit to upper case.
+ */
+#define FOLD_UNIT(unit) \
+    ((unit) >= 'a' && (unit) <= 'z' ? (unit) - ('a' - 'A') : (unit))
+
+/**
+ * @def ENTRY_NAME
+ * @brief Gets the name of the entry at a position in a directory.
+ */
+#define ENTRY_NAME(directory, index) \
+    READ_UINT32_LE((directory)->entries + (size_t) (index) * RESOURCE_ENTRY_SIZE)
+
+/**
+ * @brief Locates a string name in a resource tree.
+ *
+ * @param   tree    The resource tree.
+ * @param   name    The entry name, with the high bit set.
+ * @param   units   Receives the name's code units.
+ * @param   length  Receives the number of code units in the name.
+ * @return  1 if the name was located; 0 if it lies outside the tree.
+ */
+static int locate_name(const struct resource_tree* tree,
+                       uint32_ne name,
+                       const uint8_ne** units,
+                       uint16_ne* length)
+{
+    uint32_ne offset = name & ~(uint32_ne) RESOURCE_HIGH_BIT;
+    if (!(name & RESOURCE_HIGH_BIT)
+        || offset > tree->size
+        || tree->size - offset < 2)
+    {
+        return 0;
+    }
+    *length = READ_UINT16_LE(tree->base + offset);
+    if ((tree->size - offset - 2) / 2 < *length)
+    {
+        return 0;
+    }
+    *units = tree->base + offset + 2;
+    return 1;
+}
+
+/**
+ * @brief Compares a string name in a resource tree with a query.
+ *
+ * @param   tree    The resource tree.
+ * @param   name    The entry name, with the high bit set.
+ * @param   query   The name to compare against, as UTF-16 code units.
+ * @param   length  The number of code units in `query`.
+ * @param   order   Receives a negative, zero, or positive value if the entry
+ *                  name sorts before, equal to, or after `query`.
+ * @return  1 if the names were compared; 0 if the entry name is invalid.
+ */
+static int compare_name(const struct resource_tree* tree,
+                        uint32_ne name,
+                        const uint16_ne* query,
+                        size_t length,
+                        int* order)
+{
+    const uint8_ne* units;
+    uint16_ne name_length;
+    size_t i;
+    if (!locate_name(tree, name, &units, &name_length))
+    {
+        return 0;
+    }
+    for (i = 0; i < name_length && i < length; i++)
+    {
+        unsigned int a = READ_UINT16_LE(units + i * 2);
+        unsigned int b = query[i];
+        a = FOLD_UNIT(a);
+        b = FOLD_UNIT(b);
+        if (a != b)
+        {
+            *order = a < b ? -1 : 1;
+            return 1;
+        }
+    }
+    *order = name_length < length ? -1 : name_length > length ? 1 : 0;
+    return 1;
+}
+
+/**
+ * @brief Compares two string names in a resource tree.
+ *
+ * @param   tree    The resource tree.
+ * @param   a       The first entry name, with the high bit set.
+ * @param   b       The second entry name, with the high bit set.
+ * @param   order   Receives a negative, zero, or positive value if `a` sorts
+ *                  before, equal to, or after `b`.
+ * @return  1 if the names were compared; 0 if either name is invalid.
+ */
+static int compare_names(const struct resource_tree* tree,
+                         uint32_ne a,
+                         uint32_ne b,
+                         int* order)
+{
+    const uint8_ne* units_a;
+    const uint8_ne* units_b;
+    uint16_ne length_a;
+    uint16_ne length_b;
+    uint16_ne i;
+    if (!locate_name(tree, a, &units_a, &length_a)
+        || !locate_name(tree, b, &units_b, &length_b))
+    {
+        return 0;
+    }
+    for (i = 0; i < length_a && i < length_b; i++)
+    {
+        unsigned int unit_a = READ_UINT16_LE(units_a + i * 2);
+        unsigned int unit_b = READ_UINT16_LE(units_b + i * 2);
+        unit_a = FOLD_UNIT(unit_a);
+        unit_b = FOLD_UNIT(unit_b);
+        if (unit_a != unit_b)
+        {
+            *order = unit_a < unit_b ? -1 : 1;
+            return 1;
+        }
+    }
+    *order = length_a < length_b ? -1 : length_a > length_b ? 1 : 0;
+    return 1;
+}
+
+/**
+ * @brief Checks the sort order of the entries named by an ID.
+ *
+ * @param   directory   An open directory.
+ * @return  The sort order of the directory's ID entries.
+ */
+static enum resource_sort_state check_id_order(
+    const struct resource_directory* directory)
+{
+    unsigned int first = directory->name_count;
+    unsigned int last = first + directory->id_count;
+    unsigned int i;
+    for (i = first; i < last; i++)
+    {
+        uint32_ne id = ENTRY_NAME(directory, i);
+        if (id & RESOURCE_HIGH_BIT
+            || (i > first && ENTRY_NAME(directory, i - 1) >= id))
+        {
+            return RESOURCE_ORDER_UNSORTED;
+        }
+    }
+    return RESOURCE_ORDER_SORTED;
+}
+
+/**
+ * @brief Checks the sort order of the entries named by a string.
+ *
+ * @param   directory   An open directory.
+ * @return  The sort order of the directory's string entries.
+ */
+static enum resource_sort_state check_name_order(
+    const struct resource_directory* directory)
+{
+    unsigned int i;
+    for (i = 1; i < directory->name_count; i++)
+    {
+        int order;
+        if (!compare_names(directory->tree,
+                           ENTRY_NAME(directory, i - 1),
+                           ENTRY_NAME(directory, i),
+                           &order)
+            || order >= 0)
+        {
+            return RESOURCE_ORDER_UNSORTED;
+        }
+    }
+    return RESOURCE_ORDER_SORTED;
+}
+
+/**
+ * @brief Opens the directory at an offset in a resource tree.
+ *
+ * @param   tree        The resource tree.
+ * @param   offset      The offset of the directory table from the tree's base.
+ * @param   directory   Receives the directory.
+ * @return  1 if the directory was opened; 0 if it lies outside the tree.
+ */
+static int open_directory(const struct resource_tree* tree,
+                          uint32_ne offset,
+                          struct resource_directory* directory)
+{
+    const uint8_ne* table;
+    size_t entries_size;
+    if (offset > tree->size || tree->size - offset < RESOURCE_DIRECTORY_SIZE)
+    {
+        return 0;
+    }
+    table = tree->base + offset;
+    directory->tree = tree;
+    directory->entries = table + RESOURCE_DIRECTORY_SIZE;
+    directory->name_count = READ_UINT16_LE(table + 12);
+    directory->id_count = READ_UINT16_LE(table + 14);
+    directory->name_order = RESOURCE_ORDER_UNCHECKED;
+    directory->id_order = RESOURCE_ORDER_UNCHECKED;
+    entries_size = ((size_t) directory->name_count + directory->id_count)
+        * RESOURCE_ENTRY_SIZE;
+    if (tree->size - offset - RESOURCE_DIRECTORY_SIZE < entries_size)
+    {
+        return 0;
+    }
+    if (tree->validate)
+    {
+        validate_resource_directory(directory);
+    }
+    return 1;
+}
+
+/**
+ * @brief Locates the resource tree of a PE image.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   tree    Receives the location of the resource tree.
+ * @param   view    A view of a PE image, in its file layout.
+ * @return  1 if the image has a resource tree; 0 otherwise.
+ */
+int open_resource_tree(struct resource_tree* tree,
+                       const struct image_view* view)
+{
+    struct pe_data_directory directory;
+    size_t offset;
+    if (!read_pe_data_directory(view, PE_DIRECTORY_RESOURCE, &directory)
+        || directory.rva == 0
+        || directory.size < RESOURCE_DIRECTORY_SIZE
+        || !map_image_rva(view, directory.rva, directory.size, &offset))
+    {
+        return 0;
+    }
+    tree->view = view;
+    tree->base = view->data + offset;
+    tree->size = directory.size;
+    tree->rva = directory.rva;
+    tree->validate = 0;
+    return 1;
+}
+
+/**
+ * @brief Opens the root directory of a resource tree.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   tree        An open resource tree.
+ * @param   directory   Receives the root directory.
+ * @return  1 if the directory was opened; 0 if it lies outside the image.
+ */
+int open_resource_root(const struct resource_tree* tree,
+                       struct resource_directory* directory)
+{
+    return open_directory(tree, 0, directory);
+}
+
+/**
+ * @brief Opens the subdirectory named by a directory entry.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   entry       An entry which names a subdirectory.
+ * @param   directory   Receives the subdirectory.
+ * @return  1 if the directory was opened; 0 if `entry` names resource data,
+ *          or the directory lies outside the image.
+ */
+int open_resource_subdirectory(const struct resource_entry* entry,
+                               struct resource_directory* directory)
+{
+    if (!is_resource_subdirectory(entry))
+    {
+        return 0;
+    }
+    return open_directory(entry->tree,
+                          entry->target & ~(uint32_ne) RESOURCE_HIGH_BIT,
+                          directory);
+}
+
+/**
+ * @brief Checks that a directory's entries are sorted.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   directory   An open directory.
+ * @return  1 if the directory's entries are sorted; 0 otherwise.
+ */
+int validate_resource_directory(struct resource_directory* directory)
+{
+    directory->id_order = check_id_order(directory);
+    directory->name_order = check_name_order(directory);
+    return directory->id_order == RESOURCE_ORDER_SORTED
+        && directory->name_order == RESOURCE_ORDER_SORTED;
+}
+
+/**
+ * @brief Reads an entry from a directory by its position.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   directory   An open directory.
+ * @param   index       The zero based position of the entry.
+ * @param   entry       Receives the entry.
+ * @return  1 if the entry was read; 0 if `index` is out of range.
+ */
+int get_resource_entry(const struct resource_directory* directory,
+                       unsigned int index,
+                       struct resource_entry* entry)
+{
+    const uint8_ne* bytes;
+    if (index >= (unsigned int) directory->name_count + directory->id_count)
+    {
+        return 0;
+    }
+    bytes = directory->entries + (size_t) index * RESOURCE_ENTRY_SIZE;
+    entry->tree = directory->tree;
+    entry->name = READ_UINT32_LE(bytes);
+    entry->target = READ_UINT32_LE(bytes + 4);
+    return 1;
+}
+
+/**
+ * @brief Finds the entry with an integer ID in a directory.
+ *
+ * IDs are found by binary search, unless validate_resource_directory() found
+ * them to be unsorted, in which case they are searched linearly.
+ *
+ * @param   directory   An open directory.
+ * @param   id          The ID to find.
+ * @param   entry       Receives the entry.
+ * @return  1 if the entry was found; 0 otherwise.
+ */
+int find_resource_id(const struct resource_directory* directory,
+                     uint32_ne id,
+                     struct resource_entry* entry)
+{
+    unsigned int first = directory->name_count;
+    unsigned int last = first + directory->id_count;
+    unsigned int low = first;
+    unsigned int high = last;
+    unsigned int i;
+    if (directory->id_order != RESOURCE_ORDER_UNSORTED)
+    {
+        while (low < high)
+        {
+            unsigned int middle = low + (high - low) / 2;
+            uint32_ne middle_id = ENTRY_NAME(directory, middle);
+            if (middle_id == id)
+            {
+                return get_resource_entry(directory, middle, entry);
+            }
+            if (middle_id < id)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return 0;
+    }
+    for (i = first; i < last; i++)
+    {
+        if (ENTRY_NAME(directory, i) == id)
+        {
+            return get_resource_entry(directory, i, entry);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Finds the entry with a string name in a directory.
+ *
+ * Names are found by binary search, unless validate_resource_directory()
+ * found them to be unsorted, in which case they are searched linearly.
+ *
+ * @param   directory   An open directory.
+ * @param   name        The name to find, as UTF-16 code units.
+ * @param   length      The number of code units in `name`.
+ * @param   entry       Receives the entry.
+ * @return  1 if the entry was found; 0 otherwise.
+ */
+int find_resource_name(const struct resource_directory* directory,
+                       const uint16_ne* name,
+                       size_t length,
+                       struct resource_entry* entry)
+{
+    unsigned int low = 0;
+    unsigned int high = directory->name_count;
+    unsigned int i;
+    int order;
+    if (directory->name_order != RESOURCE_ORDER_UNSORTED)
+    {
+        while (low < high)
+        {
+            unsigned int middle = low + (high - low) / 2;
+            if (!compare_name(directory->tree,
+                              ENTRY_NAME(directory, middle),
+                              name,
+                              length,
+                              &order))
+            {
+                break;
+            }
+            if (order == 0)
+            {
+                return get_resource_entry(directory, middle, entry);
+            }
+            if (order < 0)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return 0;
+    }
+    for (i = 0; i < directory->name_count; i++)
+    {
+        if (compare_name(directory->tree,
+                         ENTRY_NAME(directory, i),
+                         name,
+                         length,
+                         &order)
+            && order == 0)
+        {
+            return get_resource_entry(directory, i, entry);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Indicates if a directory entry names a subdirectory.
+ *
+ * @param   entry   A directory entry.
+ * @return  1 if `entry` names a subdirectory; 0 if it names resource data.
+ */
+int is_resource_subdirectory(const struct resource_entry* entry)
+{
+    return (entry->target & RESOURCE_HIGH_BIT) != 0;
+}
+
+/**
+ * @brief Gets the string name of a directory entry.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   entry   A directory entry.
+ * @param   name    Receives the name, as little endian UTF-16 code units
+ *                  within the image view.
+ * @param   length  Receives the number of code units in the name.
+ * @return  1 if the name was read; 0 if `entry` is named by an ID, or the name
+ *          lies outside the image.
+ */
+int get_resource_name(const struct resource_entry* entry,
+                      const uint8_ne** name,
+                      uint16_ne* length)
+{
+    return locate_name(entry->tree, entry->name, name, length);
+}
+
+/**
+ * @brief Reads the resource data named by a directory entry.
+ *
+ * Resource data is normally stored in the same section as the resource tree,
+ * so its RVA is translated relative to the tree before the section table is
+ * consulted.
+ *
+ * @param   entry   An entry which names resource data.
+ * @param   data    Receives the resource data.
+ * @return  1 if the data was read; 0 if `entry` names a subdirectory, or the
+ *          data lies outside the image.
+ */
+int read_resource_data(const struct resource_entry* entry,
+                       struct resource_data* data)
+{
+    const struct resource_tree* tree = entry->tree;
+    const uint8_ne* bytes;
+    uint32_ne rva;
+    size_t offset;
+    if (is_resource_subdirectory(entry)
+        || entry->target > tree->size
+        || tree->size - entry->target < RESOURCE_DATA_ENTRY_SIZE)
+    {
+        return 0;
+    }
+    bytes = tree->base + entry->target;
+    rva = READ_UINT32_LE(bytes);
+    data->size = READ_UINT32_LE(bytes + 4);
+    data->codepage = READ_UINT32_LE(bytes + 8);
+    if (rva >= tree->rva
+        && rva - tree->rva <= tree->size
+        && tree->size - (rva - tree->rva) >= data->size)
+    {
+        data->data = tree->base + (rva - tree->rva);
+        return 1;
+    }
+    if (!map_image_rva(tree->view, rva, data->size, &offset))
+    {
+        return 0;
+    }
+    data->data = tree->view->data + offset;
+    return 1;
+}
+
+/**
+ * @brief Finds a resource by its type, ID, and language.
+ *
+ * @see resource.h for more information.
+ *
+ * @param   tree        An open resource tree.
+ * @param   type        The resource type; a `RESOURCE_TYPE_*` value.
+ * @param   id          The resource ID.
+ * @param   language    The language ID, or `RESOURCE_LANGUAGE_ANY`.
+ * @param   data        Receives the resource data.
+ * @return  1 if the resource was found; 0 otherwise.
+ */
+int find_resource(const struct resource_tree* tree,
+                  uint32_ne type,
+                  uint32_ne id,
+                  uint32_ne language,
+                  struct resource_data* data)
+{
+    struct resource_directory directory;
+    struct resource_entry entry;
+    if (!open_resource_root(tree, &directory)
+        || !find_resource_id(&directory, type, &entry)
+        || !open_resource_subdirectory(&entry, &directory)
+        || !find_resource_id(&directory, id, &entry)
+        || !open_resource_subdirectory(&entry, &directory))
+    {
+        return 0;
+    }
+    if (language == RESOURCE_LANGUAGE_ANY)
+    {
+        if (!get_resource_entry(&directory, directory.name_count, &entry)
+            && !get_resource_entry(&directory, 0, &entry))
+        {
+            return 0;
+        }
+    }
+    else if (!find_resource_id(&directory, language, &entry))
+    {
+        return 0;
+    }
+    return read_resource_data(&entry, data);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file section.c
+ * @brief Reads section table entries from PE/COFF images.
+ *
+ * section.c decodes the section table, and uses it to translate RVAs to file
+ * offsets.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <string.h>
+
+#include "format/format.h"
+#include "format/pecoff/coff.h"
+#include "format/pecoff/image.h"
+#include "format/pecoff/section.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @brief Decodes an entry in the section table of a PE or COFF image view.
+ *
+ * @see section.h for more information.
+ *
+ * @param   view    A view of a PE or COFF image.
+ * @param   index   The zero based index of the section.
+ * @param   header  Receives the decoded section header.
+ * @return  1 if the section header was decoded; 0 if the section does not
+ *          exist, or lies outside the view.
+ */
+int read_section_header(const struct image_view* view,
+                        unsigned int index,
+                        struct section_header* header)
+{
+    struct coff_header coff;
+    const uint8_ne* bytes;
+    size_t offset;
+    if (!read_coff_header(view, &coff) || index >= coff.section_count)
+    {
+        return 0;
+    }
+    offset = view->header_offset
+        + COFF_HEADER_SIZE
+        + coff.executable_header_size
+        + (size_t) index * SECTION_HEADER_SIZE;
+    if (offset > view->size || view->size - offset < SECTION_HEADER_SIZE)
+    {
+        return 0;
+    }
+    bytes = view->data + offset;
+    memcpy(header->name, bytes, SECTION_NAME_SIZE);
+    header->virtual_size = READ_UINT32_LE(bytes + 8);
+    header->virtual_address = READ_UINT32_LE(bytes + 12);
+    header->raw_data_size = READ_UINT32_LE(bytes + 16);
+    header->raw_data_offset = READ_UINT32_LE(bytes + 20);
+    header->relocations_offset = READ_UINT32_LE(bytes + 24);
+    header->line_numbers_offset = READ_UINT32_LE(bytes + 28);
+    header->relocation_count = READ_UINT16_LE(bytes + 32);
+    header->line_number_count = READ_UINT16_LE(bytes + 34);
+    header->characteristics = READ_UINT32_LE(bytes + 36);
+    return 1;
+}
+
+/**
+ * @brief Translates an RVA to an offset into a PE image view.
+ *
+ * @see section.h for more information.
+ *
+ * @param   view    A view of a PE image, in its file layout.
+ * @param   rva     The relative virtual address to translate.
+ * @param   size    The number of bytes which must be available at `rva`.
+ * @param   offset  Receives the offset of `rva` from the start of the view.
+ * @return  1 if the range was mapped; 0 if no section holds it, or it lies
+ *          outside the view.
+ */
+int map_image_rva(const struct image_view* view,
+                  uint32_ne rva,
+                  uint32_ne size,
+                  size_t* offset)
+{
+    struct section_header section;
+    unsigned int i;
+    for (i = 0; read_section_header(view, i, &section); i++)
+    {
+        uint32_ne delta;
+        if (rva < section.virtual_address)
+        {
+            continue;
+        }
+        delta = rva - section.virtual_address;
+        if (delta >= section.raw_data_size
+            || section.raw_data_size - delta < size)
+        {
+            continue;
+        }
+        if (section.raw_data_offset > view->size
+            || view->size - section.raw_data_offset < delta
+            || view->size - section.raw_data_offset - delta < size)
+        {
+            return 0;
+        }
+        *offset = (size_t) section.raw_data_offset + delta;
+        return 1;
+    }
+    return 0;
+}
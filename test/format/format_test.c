@@ -0,0 +1,333 @@
+/**
+ * @file format_test.c
+ * @brief Checks image format identification in format.c and its backends.
+ *
+ * format_test builds the headers of PE, ELF, and COFF images in memory and
+ * checks each is identified by sniff_image() and its backend's sniff
+ * function, then checks that damaged and truncated headers are rejected.
+ * sniff_image_file() is checked with a file shorter than a page, and with a
+ * stream which cannot be read.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "format/elf/elf.h"
+#include "format/format.h"
+#include "format/pecoff/image.h"
+#include "format/pecoff/machines.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @def PE_OFFSET
+ * @brief The offset of the PE signature in the test PE images.
+ */
+#define PE_OFFSET       0x40
+
+/**
+ * @def PE_SIZE
+ * @brief The size of the test PE images; up to the end of the optional magic.
+ */
+#define PE_SIZE         (PE_OFFSET + 4 + 20 + 2)
+
+/**
+ * @def TEST_FILE
+ * @brief The name of the file sniff_image_file() is checked against.
+ */
+#define TEST_FILE       "format_test.tmp"
+
+/**
+ * @var failures
+ * @brief The number of checks which have failed.
+ */
+static int failures = 0;
+
+/**
+ * @brief Writes the headers of a PE image.
+ *
+ * @param   image       Receives the headers; `PE_SIZE` bytes.
+ * @param   machine_id  The COFF machine ID.
+ * @param   magic       The optional header's magic number.
+ */
+static void build_pe(uint8_ne* image, uint16_ne machine_id, uint16_ne magic)
+{
+    uint8_ne* coff = image + PE_OFFSET + 4;
+    memset(image, 0, PE_SIZE);
+    image[0] = 'M';
+    image[1] = 'Z';
+    WRITE_UINT32_LE(image + 0x3c, PE_OFFSET);
+    memcpy(image + PE_OFFSET, "PE\0\0", 4);
+    WRITE_UINT16_LE(coff, machine_id);
+    WRITE_UINT16_LE(coff + 2, 1);
+    WRITE_UINT16_LE(coff + 16, magic == 0x20b ? 0xf0 : 0xe0);
+    WRITE_UINT16_LE(coff + 18, 0x0102);
+    WRITE_UINT16_LE(coff + 20, magic);
+}
+
+/**
+ * @brief Writes the header of an ELF image.
+ *
+ * @param   image       Receives the header; `ELF64_HEADER_SIZE` bytes.
+ * @param   class       `ELF_CLASS_32` or `ELF_CLASS_64`.
+ * @param   encoding    `ELF_DATA_LSB` or `ELF_DATA_MSB`.
+ * @param   machine     The ELF machine number.
+ */
+static void build_elf(uint8_ne* image,
+                      uint8_ne class,
+                      uint8_ne encoding,
+                      uint16_ne machine)
+{
+    memset(image, 0, ELF64_HEADER_SIZE);
+    image[ELF_IDENT_MAG0] = ELF_MAG0;
+    image[ELF_IDENT_MAG1] = ELF_MAG1;
+    image[ELF_IDENT_MAG2] = ELF_MAG2;
+    image[ELF_IDENT_MAG3] = ELF_MAG3;
+    image[ELF_IDENT_CLASS] = class;
+    image[ELF_IDENT_DATA] = encoding;
+    image[ELF_IDENT_VERSION] = ELF_VERSION_CURRENT;
+    if (encoding == ELF_DATA_MSB)
+    {
+        image[ELF_MACHINE_OFFSET] = (uint8_ne) (machine >> 8);
+        image[ELF_MACHINE_OFFSET + 1] = (uint8_ne) machine;
+    }
+    else
+    {
+        WRITE_UINT16_LE(image + ELF_MACHINE_OFFSET, machine);
+    }
+}
+
+/**
+ * @brief Writes the header of a bare COFF object.
+ *
+ * @param   image               Receives the header; `COFF_HEADER_SIZE` bytes.
+ * @param   machine_id          The COFF machine ID.
+ * @param   section_count       The number of sections.
+ * @param   executable_size     The size of the executable header.
+ */
+static void build_coff(uint8_ne* image,
+                       uint16_ne machine_id,
+                       uint16_ne section_count,
+                       uint16_ne executable_size)
+{
+    memset(image, 0, COFF_HEADER_SIZE);
+    WRITE_UINT16_LE(image, machine_id);
+    WRITE_UINT16_LE(image + 2, section_count);
+    WRITE_UINT16_LE(image + 16, executable_size);
+}
+
+/**
+ * @brief Checks sniff_image() identifies an image, and describes it.
+ */
+static void check_sniffed(const char* name,
+                          const uint8_ne* image,
+                          size_t size,
+                          enum image_format format,
+                          uint16_ne machine,
+                          unsigned int word_size,
+                          enum image_byte_order byte_order,
+                          size_t header_offset)
+{
+    struct image_view view;
+    if (!sniff_image(image, size, &view)
+        || view.format != format
+        || view.backend == NULL
+        || view.backend->format != format
+        || view.data != image
+        || view.size != size
+        || view.machine != machine
+        || view.word_size != word_size
+        || view.byte_order != byte_order
+        || view.header_offset != header_offset)
+    {
+        fprintf(stderr, "%s is not identified\n", name);
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks sniff_image() rejects an image, and clears the description.
+ */
+static void check_rejected(const char* name,
+                           const uint8_ne* image,
+                           size_t size)
+{
+    struct image_view view;
+    if (sniff_image(image, size, &view)
+        || view.format != IMAGE_FORMAT_UNKNOWN
+        || view.backend != NULL)
+    {
+        fprintf(stderr, "%s is identified\n", name);
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks a backend's sniff function accepts or rejects an image.
+ */
+static void check_backend(const char* name,
+                          int (*sniff)(const uint8_ne*,
+                                       size_t,
+                                       struct image_view*),
+                          const uint8_ne* image,
+                          size_t size,
+                          int expected)
+{
+    struct image_view view;
+    if (sniff(image, size, &view) != expected)
+    {
+        fprintf(stderr, "%s is %s by its backend\n",
+                name,
+                expected ? "rejected" : "accepted");
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks sniff_image_file() against a file and a stream which cannot
+ *        be read.
+ */
+static void check_files(void)
+{
+    static uint8_ne page[IMAGE_SNIFF_SIZE];
+    uint8_ne image[ELF64_HEADER_SIZE];
+    struct image_view view;
+    FILE* file;
+    build_elf(image, ELF_CLASS_64, ELF_DATA_LSB, 62);
+    file = fopen(TEST_FILE, "wb");
+    if (file == NULL
+        || fwrite(image, 1, sizeof(image), file) != sizeof(image)
+        || fclose(file) != 0)
+    {
+        fprintf(stderr, "cannot write %s\n", TEST_FILE);
+        failures++;
+        return;
+    }
+
+    /* A file shorter than a page is read in full. */
+    file = fopen(TEST_FILE, "rb");
+    if (file == NULL
+        || !sniff_image_file(file, page, sizeof(page), &view)
+        || view.format != IMAGE_FORMAT_ELF
+        || view.data != page
+        || view.size != sizeof(image))
+    {
+        fprintf(stderr, "short file is not identified\n");
+        failures++;
+    }
+
+    /* A read shorter than the header is rejected. */
+    if (file != NULL)
+    {
+        rewind(file);
+        if (sniff_image_file(file, page, ELF64_HEADER_SIZE - 1, &view))
+        {
+            fprintf(stderr, "short read is identified\n");
+            failures++;
+        }
+        fclose(file);
+    }
+
+    /* A stream which cannot be read is rejected, whatever is in the page. */
+    memcpy(page, image, sizeof(image));
+    file = fopen(TEST_FILE, "ab");
+    if (file == NULL
+        || sniff_image_file(file, page, sizeof(page), &view)
+        || view.format != IMAGE_FORMAT_UNKNOWN
+        || view.size != 0)
+    {
+        fprintf(stderr, "unreadable stream is identified\n");
+        failures++;
+    }
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    remove(TEST_FILE);
+}
+
+int main(void)
+{
+    uint8_ne pe32[PE_SIZE];
+    uint8_ne pe32_plus[PE_SIZE];
+    uint8_ne elf[ELF64_HEADER_SIZE];
+    uint8_ne coff[COFF_HEADER_SIZE];
+    uint8_ne image[PE_SIZE];
+
+    /* Every format is identified. */
+    build_pe(pe32, COFF_MACH_I386, 0x10b);
+    check_sniffed("PE32", pe32, PE_SIZE, IMAGE_FORMAT_PE,
+                  COFF_MACH_I386, 32, IMAGE_LITTLE_ENDIAN, PE_OFFSET + 4);
+    check_backend("PE32", sniff_pe_image, pe32, PE_SIZE, 1);
+    build_pe(pe32_plus, COFF_MACH_AMD64, 0x20b);
+    check_sniffed("PE32+", pe32_plus, PE_SIZE, IMAGE_FORMAT_PE,
+                  COFF_MACH_AMD64, 64, IMAGE_LITTLE_ENDIAN, PE_OFFSET + 4);
+    build_elf(elf, ELF_CLASS_32, ELF_DATA_LSB, 3);
+    check_sniffed("ELF32 LSB", elf, ELF32_HEADER_SIZE, IMAGE_FORMAT_ELF,
+                  3, 32, IMAGE_LITTLE_ENDIAN, 0);
+    check_backend("ELF32 LSB", sniff_elf_image, elf, ELF32_HEADER_SIZE, 1);
+    build_elf(elf, ELF_CLASS_32, ELF_DATA_MSB, 8);
+    check_sniffed("ELF32 MSB", elf, ELF32_HEADER_SIZE, IMAGE_FORMAT_ELF,
+                  8, 32, IMAGE_BIG_ENDIAN, 0);
+    build_elf(elf, ELF_CLASS_64, ELF_DATA_LSB, 62);
+    check_sniffed("ELF64 LSB", elf, ELF64_HEADER_SIZE, IMAGE_FORMAT_ELF,
+                  62, 64, IMAGE_LITTLE_ENDIAN, 0);
+    build_elf(elf, ELF_CLASS_64, ELF_DATA_MSB, 0x2b);
+    check_sniffed("ELF64 MSB", elf, ELF64_HEADER_SIZE, IMAGE_FORMAT_ELF,
+                  0x2b, 64, IMAGE_BIG_ENDIAN, 0);
+    build_coff(coff, COFF_MACH_AMD64, 3, 0);
+    check_sniffed("COFF", coff, COFF_HEADER_SIZE, IMAGE_FORMAT_COFF,
+                  COFF_MACH_AMD64, 64, IMAGE_LITTLE_ENDIAN, 0);
+    check_backend("COFF", sniff_coff_object, coff, COFF_HEADER_SIZE, 1);
+
+    /* Truncated headers are rejected. */
+    check_rejected("truncated MS-DOS header", pe32, 0x3f);
+    check_rejected("truncated COFF header", pe32, PE_OFFSET + 4 + 19);
+    check_backend("truncated COFF header", sniff_pe_image,
+                  pe32, PE_OFFSET + 4 + 19, 0);
+    check_rejected("truncated ELF32", elf, ELF32_HEADER_SIZE - 1);
+    check_rejected("truncated ELF64", elf, ELF64_HEADER_SIZE - 1);
+    check_backend("truncated ELF64", sniff_elf_image,
+                  elf, ELF64_HEADER_SIZE - 1, 0);
+    check_rejected("truncated COFF", coff, COFF_HEADER_SIZE - 1);
+    check_rejected("empty image", coff, 0);
+
+    /* Damaged headers are rejected. */
+    memcpy(image, pe32, PE_SIZE);
+    WRITE_UINT32_LE(image + 0x3c, PE_SIZE + 1);
+    check_rejected("PE offset past the image", image, PE_SIZE);
+    check_backend("PE offset past the image", sniff_pe_image,
+                  image, PE_SIZE, 0);
+    WRITE_UINT32_LE(image + 0x3c, 0xfffffff0);
+    check_rejected("PE offset past the address space", image, PE_SIZE);
+    WRITE_UINT32_LE(image + 0x3c, PE_OFFSET);
+    image[PE_OFFSET + 2] = 'X';
+    check_rejected("bad PE signature", image, PE_SIZE);
+    build_elf(elf, ELF_CLASS_64, 3, 62);
+    check_rejected("bad ELF encoding", elf, ELF64_HEADER_SIZE);
+    build_elf(elf, 3, ELF_DATA_LSB, 62);
+    check_rejected("bad ELF class", elf, ELF64_HEADER_SIZE);
+    build_coff(coff, COFF_MACH_UNKNOWN, 3, 0);
+    check_rejected("COFF machine UNKNOWN", coff, COFF_HEADER_SIZE);
+    check_backend("COFF machine UNKNOWN", sniff_coff_object,
+                  coff, COFF_HEADER_SIZE, 0);
+    build_coff(coff, 0x1234, 3, 0);
+    check_rejected("unknown COFF machine", coff, COFF_HEADER_SIZE);
+    build_coff(coff, COFF_MACH_AMD64, 0, 0);
+    check_rejected("COFF without sections", coff, COFF_HEADER_SIZE);
+    build_coff(coff, COFF_MACH_AMD64, 3, 0xf0);
+    check_rejected("COFF with an executable header", coff, COFF_HEADER_SIZE);
+    check_backend("COFF with an executable header", sniff_coff_object,
+                  coff, COFF_HEADER_SIZE, 0);
+
+    check_files();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file filter_test.c
+ * @brief Checks the batch header filter in filter.c.
+ *
+ * filter_coff_headers() tests headers in blocks, with branch free loops,
+ * so it must agree with the scalar is_coff_header_accepted() on every
+ * header. filter_test filters more than three blocks of pseudo random
+ * headers with mixed machines and characteristics, and compares the two.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "format/pecoff/characteristics.h"
+#include "format/pecoff/coff.h"
+#include "format/pecoff/filter.h"
+#include "format/pecoff/machines.h"
+#include "platform/types.h"
+
+
+/**
+ * @def HEADER_COUNT
+ * @brief The number of headers filtered; not a multiple of the block size.
+ */
+#define HEADER_COUNT    (3 * MACHINE_FILTER_BLOCK + 77)
+
+/**
+ * @def REQUIRED
+ * @brief The characteristics accepted headers must set.
+ */
+#define REQUIRED        PE_IMAGE_EXECUTABLE
+
+/**
+ * @def REJECTED
+ * @brief The characteristics accepted headers must clear.
+ */
+#define REJECTED        COFF_DLL
+
+/**
+ * @var test_machines
+ * @brief The machine IDs the headers are drawn from, including unknown IDs.
+ */
+static const uint16_ne test_machines[] =
+{
+    COFF_MACH_AMD64, COFF_MACH_I386, COFF_MACH_ARM64, COFF_MACH_ARM,
+    COFF_MACH_UNKNOWN, COFF_MACH_IA64, 0x1234, 0xffff
+};
+
+/**
+ * @brief Generates the next pseudo random number in a fixed sequence.
+ *
+ * @param   state   The generator's state.
+ * @return  A pseudo random number.
+ */
+static uint32_ne next_random(uint32_ne* state)
+{
+    *state = (*state * 1103515245 + 12345) & 0xffffffff;
+    return *state >> 8;
+}
+
+int main(void)
+{
+    static struct coff_header headers[HEADER_COUNT];
+    static size_t matches[HEADER_COUNT];
+    static uint16_ne machine_ids[HEADER_COUNT];
+    static uint16_ne characteristics[HEADER_COUNT];
+    static uint8_ne accepted[HEADER_COUNT];
+    static size_t offset_matches[HEADER_COUNT];
+    struct machine_filter filter;
+    uint32_ne state = 1;
+    size_t match_count;
+    size_t expected_count = 0;
+    size_t i;
+    int failures = 0;
+    init_machine_filter(&filter,
+                        COFF_CAP_X86 | COFF_CAP_X86_64,
+                        REQUIRED,
+                        REJECTED);
+    for (i = 0; i < HEADER_COUNT; i++)
+    {
+        uint32_ne random = next_random(&state);
+        headers[i].machine_id = test_machines[random % 8];
+        headers[i].characteristics = (uint16_ne) (random >> 3);
+        machine_ids[i] = headers[i].machine_id;
+        characteristics[i] = headers[i].characteristics;
+    }
+    match_count = filter_coff_headers(&filter, headers, HEADER_COUNT, matches);
+    for (i = 0; i < HEADER_COUNT; i++)
+    {
+        int is_accepted = is_coff_header_accepted(&filter, &headers[i]);
+        int is_matched = expected_count < match_count
+            && matches[expected_count] == i;
+        if (is_accepted != is_matched)
+        {
+            fprintf(stderr, "header %lu is %s by the batch filter only\n",
+                    (unsigned long) i,
+                    is_matched ? "accepted" : "rejected");
+            failures++;
+            break;
+        }
+        expected_count += (size_t) is_accepted;
+        if (is_accepted
+            && ((headers[i].characteristics & REQUIRED) != REQUIRED
+                || headers[i].characteristics & REJECTED
+                || (headers[i].machine_id != COFF_MACH_AMD64
+                    && headers[i].machine_id != COFF_MACH_I386)))
+        {
+            fprintf(stderr, "header %lu is accepted against the masks\n",
+                    (unsigned long) i);
+            failures++;
+        }
+    }
+    if (match_count != expected_count)
+    {
+        fprintf(stderr, "batch filter accepted %lu headers; expected %lu\n",
+                (unsigned long) match_count,
+                (unsigned long) expected_count);
+        failures++;
+    }
+    if (match_count == 0 || match_count == HEADER_COUNT)
+    {
+        fprintf(stderr, "headers are not mixed\n");
+        failures++;
+    }
+    for (i = 1; i < match_count; i++)
+    {
+        if (matches[i - 1] >= matches[i])
+        {
+            fprintf(stderr, "matches are not ascending at %lu\n",
+                    (unsigned long) i);
+            failures++;
+        }
+    }
+
+    /* A single batch, offset by its first position, agrees too. */
+    mark_coff_machines(&filter,
+                       machine_ids,
+                       characteristics,
+                       HEADER_COUNT,
+                       accepted);
+    for (i = 0; i < HEADER_COUNT; i++)
+    {
+        if (accepted[i] > 1)
+        {
+            fprintf(stderr, "header %lu is marked %u\n",
+                    (unsigned long) i,
+                    (unsigned int) accepted[i]);
+            failures++;
+        }
+    }
+    if (compact_coff_matches(accepted, HEADER_COUNT, 1000, offset_matches)
+        != match_count)
+    {
+        fprintf(stderr, "compacted batch has the wrong number of matches\n");
+        failures++;
+    }
+    for (i = 0; i < match_count; i++)
+    {
+        if (offset_matches[i] != matches[i] + 1000)
+        {
+            fprintf(stderr, "compacted match %lu is misplaced\n",
+                    (unsigned long) i);
+            failures++;
+            break;
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file machines_test.c
+ * @brief Checks the machine table in machines.c.
+ *
+ * get_coff_machine_info() binary searches the machine table, so an entry out
+ * of order would silently make known machines unknown. machines_test walks
+ * the table, and checks every machine can be found.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "format/pecoff/machines.h"
+#include "platform/types.h"
+
+
+/**
+ * @var named_machines
+ * @brief Every machine ID defined in machines.h.
+ */
+static const uint16_ne named_machines[] =
+{
+    COFF_MACH_UNKNOWN, COFF_MACH_AM33, COFF_MACH_AMD64, COFF_MACH_ARM,
+    COFF_MACH_ARM64, COFF_MACH_ARMNT, COFF_MACH_EBC, COFF_MACH_I386,
+    COFF_MACH_IA64, COFF_MACH_M32R, COFF_MACH_MIPS16, COFF_MACH_MIPSFPU,
+    COFF_MACH_MIPSFPU16, COFF_MACH_POWERPC, COFF_MACH_POWERPCFP,
+    COFF_MACH_MIPS, COFF_MACH_RISCV32, COFF_MACH_RISCV64, COFF_MACH_RISCV128,
+    COFF_MACH_SH3, COFF_MACH_SH3DP, COFF_MACH_SH4, COFF_MACH_SH5,
+    COFF_MACH_THUMB, COFF_MACH_WCEMIPSV2,
+};
+
+int main(void)
+{
+    const struct coff_machine_info* machines;
+    const char* unrecognised = get_coff_machine_name(0xffff);
+    size_t machine_count;
+    size_t i;
+    int failures = 0;
+    machines = list_coff_machines(&machine_count);
+    if (machine_count != sizeof(named_machines) / sizeof(uint16_ne))
+    {
+        fprintf(stderr, "machine table has %lu entries; expected %lu\n",
+                (unsigned long) machine_count,
+                (unsigned long) (sizeof(named_machines) / sizeof(uint16_ne)));
+        failures++;
+    }
+    for (i = 1; i < machine_count; i++)
+    {
+        if (machines[i - 1].id >= machines[i].id)
+        {
+            fprintf(stderr, "machine table is not sorted at 0x%x\n",
+                    (unsigned int) machines[i].id);
+            failures++;
+        }
+    }
+    for (i = 0; i < sizeof(named_machines) / sizeof(uint16_ne); i++)
+    {
+        uint16_ne id = named_machines[i];
+        const struct coff_machine_info* info = get_coff_machine_info(id);
+        if (info == NULL || info->id != id || !is_coff_machine_known(id))
+        {
+            fprintf(stderr, "machine 0x%x is not found\n", (unsigned int) id);
+            failures++;
+        }
+        if (strcmp(get_coff_machine_name(id), unrecognised) == 0)
+        {
+            fprintf(stderr, "machine 0x%x has no name\n", (unsigned int) id);
+            failures++;
+        }
+    }
+    if (is_coff_machine_known(0xffff))
+    {
+        fprintf(stderr, "machine 0xffff is known\n");
+        failures++;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,758 @@
+/**
+ * @file object_test.c
+ * @brief Checks the relocations applied by link_coff_object().
+ *
+ * object_test builds a small `COFF_MACH_AMD64` object from the tables below,
+ * links it at two fixed load addresses, one of them zero, and compares the
+ * patched fields with addresses worked out by hand. Nothing is run, so the
+ * test passes on any host.
+ *
+ * The object's sections are laid out from the load address as follows:
+ *
+ * - `.text` at +0x00, with REL32_4 to `.bss` at +6, a call to `ext_val` at
+ *   +15, REL32 to `a_really_long_symbol_name` at +21, REL32 to `.bss` at
+ *   +27, and REL32 to `.data` with addend 8 at +34.
+ * - `.data` at +0x30, with ADDR64 to `.rdata` with addend 4 at +8.
+ *   `a_really_long_symbol_name` is defined at +0.
+ * - `.rdata` at +0x40.
+ * - `.bss` at +0x50.
+ * - `.xdata` at +0x54, with ADDR32NB to `compute` with addend 0x20 at +0,
+ *   SECREL to `a_really_long_symbol_name` with addend 8 at +4, SECTION to
+ *   the same symbol at +8, and ADDR64 to the weak external `maybe`, which
+ *   defaults to `compute`, at +16.
+ * - `.debug$S`, which is discardable and has a relocation against a symbol
+ *   which does not exist, so it must not be loaded.
+ *
+ * The resolver places `ext_val` 4 GiB above the load address, so the call
+ * must be sent through a branch stub. The stubs for `ext_val` and `maybe`
+ * follow at +0x70.
+ *
+ * A second pair of objects holds the same far call in a code section, and
+ * in a data section. Only the call in the code section may use a stub.
+ *
+ * Finally, a `COFF_MACH_I386` object is linked at 0x400000, with `.text` at
+ * +0x00 and `.data` at +0x14:
+ *
+ * - `.text` holds DIR32 to `_counter` at +1, and REL32 to `_helper`, which
+ *   is defined at +0x10, at +6.
+ * - `.data` holds `_counter` at +0, then DIR32 to `_counter` with addend 4
+ *   at +4, DIR32NB to `_helper` at +8, SECREL to `_helper` with addend 2 at
+ *   +12, and SECTION to `_helper` at +16.
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "format/format.h"
+#include "format/pecoff/machines.h"
+#include "format/pecoff/object.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @def EXTERNAL_DISTANCE
+ * @brief The distance of `ext_val` from the load address; out of reach of a
+ * REL32.
+ */
+#define EXTERNAL_DISTANCE   ((uint64_ne) 1 << 32)
+
+/**
+ * @def MAXIMUM_SYMBOLS
+ * @brief The largest symbol table object_test will link.
+ */
+#define MAXIMUM_SYMBOLS     64
+
+/**
+ * @def MAXIMUM_SECTIONS
+ * @brief The largest section table object_test will link.
+ */
+#define MAXIMUM_SECTIONS    16
+
+/**
+ * @def COUNT
+ * @brief The number of elements in an array.
+ */
+#define COUNT(array)        (sizeof(array) / sizeof((array)[0]))
+
+/**
+ * @struct test_relocation
+ * @brief A relocation table entry of a test object.
+ */
+struct test_relocation
+{
+    uint32_ne offset;
+    uint32_ne symbol;
+    uint16_ne type;
+};
+
+/**
+ * @struct test_section
+ * @brief A section of a test object.
+ *
+ * Uninitialised sections have no data, but a nonzero size.
+ */
+struct test_section
+{
+    const char* name;
+    const uint8_ne* data;
+    uint32_ne size;
+    uint32_ne characteristics;
+    const struct test_relocation* relocations;
+    uint16_ne relocation_count;
+};
+
+/**
+ * @struct test_symbol
+ * @brief A symbol table record of a test object.
+ *
+ * A record with no name is an auxiliary record; its value is written as the
+ * tag index of a weak external.
+ */
+struct test_symbol
+{
+    const char* name;
+    uint32_ne value;
+    int section_number;
+    uint8_ne storage_class;
+    uint8_ne auxiliary_count;
+};
+
+static const uint8_ne amd64_text[] =
+{
+    0x48, 0x83, 0xec, 0x28,                 /* sub rsp, 40 */
+    0xc7, 0x05, 0, 0, 0, 0, 7, 0, 0, 0,     /* mov dword [rel .bss], 7 */
+    0xe8, 0, 0, 0, 0,                       /* call ext_val */
+    0x03, 0x05, 0, 0, 0, 0,                 /* add eax, [rel long_name] */
+    0x03, 0x05, 0, 0, 0, 0,                 /* add eax, [rel .bss] */
+    0x48, 0x8b, 0x0d, 8, 0, 0, 0,           /* mov rcx, [rel .data + 8] */
+    0x03, 0x01,                             /* add eax, [rcx] */
+    0x48, 0x83, 0xc4, 0x28,                 /* add rsp, 40 */
+    0xc3                                    /* ret */
+};
+
+static const struct test_relocation amd64_text_relocations[] =
+{
+    {6,  4, COFF_REL_AMD64_REL32_4},
+    {15, 6, COFF_REL_AMD64_REL32},
+    {21, 7, COFF_REL_AMD64_REL32},
+    {27, 4, COFF_REL_AMD64_REL32},
+    {34, 2, COFF_REL_AMD64_REL32}
+};
+
+static const uint8_ne amd64_data[] =
+{
+    5, 0, 0, 0, 0, 0, 0, 0,                 /* long_name: dd 5, 0 */
+    4, 0, 0, 0, 0, 0, 0, 0                  /* dq .rdata + 4 */
+};
+
+static const struct test_relocation amd64_data_relocations[] =
+{
+    {8, 3, COFF_REL_AMD64_ADDR64}
+};
+
+static const uint8_ne amd64_rdata[] =
+{
+    10, 0, 0, 0, 20, 0, 0, 0, 30, 0, 0, 0, 40, 0, 0, 0
+};
+
+static const uint8_ne amd64_xdata[] =
+{
+    0x20, 0, 0, 0,                          /* dd compute + 0x20 wrt image */
+    8, 0, 0, 0,                             /* dd long_name + 8 wrt section */
+    0, 0, 0, 0, 0, 0, 0, 0,                 /* dw section long_name */
+    0, 0, 0, 0, 0, 0, 0, 0                  /* dq maybe */
+};
+
+static const struct test_relocation amd64_xdata_relocations[] =
+{
+    {0,  5, COFF_REL_AMD64_ADDR32NB},
+    {4,  7, COFF_REL_AMD64_SECREL},
+    {8,  7, COFF_REL_AMD64_SECTION},
+    {16, 8, COFF_REL_AMD64_ADDR64}
+};
+
+static const uint8_ne amd64_debug[] =
+{
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa
+};
+
+static const struct test_relocation amd64_debug_relocations[] =
+{
+    {0, 99, COFF_REL_AMD64_ADDR64}
+};
+
+static const struct test_section amd64_sections[] =
+{
+    {".text", amd64_text, sizeof(amd64_text), 0x60500020,
+     amd64_text_relocations, COUNT(amd64_text_relocations)},
+    {".data", amd64_data, sizeof(amd64_data), 0xc0400040,
+     amd64_data_relocations, COUNT(amd64_data_relocations)},
+    {".rdata", amd64_rdata, sizeof(amd64_rdata), 0x40300040, NULL, 0},
+    {".bss", NULL, 4, 0xc0300080, NULL, 0},
+    {".xdata", amd64_xdata, sizeof(amd64_xdata), 0x40300040,
+     amd64_xdata_relocations, COUNT(amd64_xdata_relocations)},
+    {".debug$S", amd64_debug, sizeof(amd64_debug), 0x42100040,
+     amd64_debug_relocations, COUNT(amd64_debug_relocations)}
+};
+
+static const struct test_symbol amd64_symbols[] =
+{
+    {".text", 0, 1, COFF_CLASS_STATIC, 1},
+    {NULL, 0, 0, 0, 0},
+    {".data", 0, 2, COFF_CLASS_STATIC, 0},
+    {".rdata", 0, 3, COFF_CLASS_STATIC, 0},
+    {".bss", 0, 4, COFF_CLASS_STATIC, 0},
+    {"compute", 0, 1, COFF_CLASS_EXTERNAL, 0},
+    {"ext_val", 0, COFF_SYMBOL_UNDEFINED, COFF_CLASS_EXTERNAL, 0},
+    {"a_really_long_symbol_name", 0, 2, COFF_CLASS_EXTERNAL, 0},
+    {"maybe", 0, COFF_SYMBOL_UNDEFINED, COFF_CLASS_WEAK_EXTERNAL, 1},
+    {NULL, 5, 0, 0, 0}
+};
+
+static const uint8_ne far_call[] =
+{
+    0xe8, 0, 0, 0, 0                        /* call ext_val */
+};
+
+static const struct test_relocation far_call_relocations[] =
+{
+    {1, 0, COFF_REL_AMD64_REL32}
+};
+
+static const struct test_section far_code_sections[] =
+{
+    {".text", far_call, sizeof(far_call), 0x60500020,
+     far_call_relocations, COUNT(far_call_relocations)}
+};
+
+static const struct test_section far_data_sections[] =
+{
+    {".data", far_call, sizeof(far_call), 0xc0400040,
+     far_call_relocations, COUNT(far_call_relocations)}
+};
+
+static const struct test_symbol far_symbols[] =
+{
+    {"ext_val", 0, COFF_SYMBOL_UNDEFINED, COFF_CLASS_EXTERNAL, 0}
+};
+
+static const uint8_ne i386_text[] =
+{
+    0xa1, 0, 0, 0, 0,                       /* mov eax, [_counter] */
+    0xe8, 0, 0, 0, 0,                       /* call _helper */
+    0xc3,                                   /* ret */
+    0x90, 0x90, 0x90, 0x90, 0x90,           /* align 16 */
+    0xc3                                    /* _helper: ret */
+};
+
+static const struct test_relocation i386_text_relocations[] =
+{
+    {1, 3, COFF_REL_I386_DIR32},
+    {6, 2, COFF_REL_I386_REL32}
+};
+
+static const uint8_ne i386_data[] =
+{
+    0x11, 0, 0, 0,                          /* _counter: dd 0x11 */
+    4, 0, 0, 0,                             /* dd _counter + 4 */
+    0, 0, 0, 0,                             /* dd _helper wrt image */
+    2, 0, 0, 0,                             /* dd _helper + 2 wrt section */
+    0, 0, 0, 0                              /* dw section _helper */
+};
+
+static const struct test_relocation i386_data_relocations[] =
+{
+    {4,  3, COFF_REL_I386_DIR32},
+    {8,  2, COFF_REL_I386_DIR32NB},
+    {12, 2, COFF_REL_I386_SECREL},
+    {16, 2, COFF_REL_I386_SECTION}
+};
+
+static const struct test_section i386_sections[] =
+{
+    {".text", i386_text, sizeof(i386_text), 0x60500020,
+     i386_text_relocations, COUNT(i386_text_relocations)},
+    {".data", i386_data, sizeof(i386_data), 0xc0300040,
+     i386_data_relocations, COUNT(i386_data_relocations)}
+};
+
+static const struct test_symbol i386_symbols[] =
+{
+    {".text", 0, 1, COFF_CLASS_STATIC, 0},
+    {".data", 0, 2, COFF_CLASS_STATIC, 0},
+    {"_helper", 0x10, 1, COFF_CLASS_EXTERNAL, 0},
+    {"_counter", 0, 2, COFF_CLASS_EXTERNAL, 0}
+};
+
+/**
+ * @var resolve_calls
+ * @brief The number of times resolve() has been called.
+ */
+static int resolve_calls = 0;
+
+/**
+ * @var failures
+ * @brief The number of checks which have failed.
+ */
+static int failures = 0;
+
+/**
+ * @brief Writes a COFF object file.
+ *
+ * Names longer than eight bytes are written to the string table.
+ *
+ * @param   machine_id      The object's `COFF_MACH_*` machine ID.
+ * @param   sections        The object's sections.
+ * @param   section_count   The number of sections.
+ * @param   symbols         The object's symbol table records.
+ * @param   symbol_count    The number of symbol table records.
+ * @param   file            Receives the object file.
+ * @param   file_size       The size of `file`, in bytes.
+ * @return  The size of the object file, or zero if it does not fit.
+ */
+static size_t build_object(uint16_ne machine_id,
+                           const struct test_section* sections,
+                           unsigned int section_count,
+                           const struct test_symbol* symbols,
+                           unsigned int symbol_count,
+                           uint8_ne* file,
+                           size_t file_size)
+{
+    size_t offset = 20 + (size_t) section_count * 40;
+    size_t strings_size = 4;
+    unsigned int i;
+    unsigned int j;
+    memset(file, 0, file_size);
+    WRITE_UINT16_LE(file, machine_id);
+    WRITE_UINT16_LE(file + 2, section_count);
+    for (i = 0; i < section_count; i++)
+    {
+        const struct test_section* section = &sections[i];
+        uint8_ne* header = file + 20 + (size_t) i * 40;
+        size_t needed = (section->data != NULL ? section->size : 0)
+            + (size_t) section->relocation_count * 10;
+        if (file_size - offset < needed)
+        {
+            return 0;
+        }
+        memcpy(header, section->name, strlen(section->name));
+        WRITE_UINT32_LE(header + 16, section->size);
+        WRITE_UINT32_LE(header + 36, section->characteristics);
+        if (section->data != NULL)
+        {
+            WRITE_UINT32_LE(header + 20, offset);
+            memcpy(file + offset, section->data, section->size);
+            offset += section->size;
+        }
+        if (section->relocation_count != 0)
+        {
+            WRITE_UINT32_LE(header + 24, offset);
+            WRITE_UINT16_LE(header + 32, section->relocation_count);
+        }
+        for (j = 0; j < section->relocation_count; j++, offset += 10)
+        {
+            WRITE_UINT32_LE(file + offset, section->relocations[j].offset);
+            WRITE_UINT32_LE(file + offset + 4,
+                            section->relocations[j].symbol);
+            WRITE_UINT16_LE(file + offset + 8, section->relocations[j].type);
+        }
+    }
+    WRITE_UINT32_LE(file + 8, offset);
+    WRITE_UINT32_LE(file + 12, symbol_count);
+    if ((file_size - offset) / 18 < symbol_count + 1)
+    {
+        return 0;
+    }
+    for (i = 0; i < symbol_count; i++, offset += 18)
+    {
+        const struct test_symbol* symbol = &symbols[i];
+        uint8_ne* record = file + offset;
+        size_t length;
+        if (symbol->name == NULL)
+        {
+            WRITE_UINT32_LE(record, symbol->value);
+            WRITE_UINT32_LE(record + 4, 3);
+            continue;
+        }
+        length = strlen(symbol->name);
+        if (length <= 8)
+        {
+            memcpy(record, symbol->name, length);
+        }
+        else
+        {
+            WRITE_UINT32_LE(record + 4, strings_size);
+            strings_size += length + 1;
+        }
+        WRITE_UINT32_LE(record + 8, symbol->value);
+        WRITE_UINT16_LE(record + 12, symbol->section_number & 0xffff);
+        record[16] = symbol->storage_class;
+        record[17] = symbol->auxiliary_count;
+    }
+    if (file_size - offset < strings_size)
+    {
+        return 0;
+    }
+    WRITE_UINT32_LE(file + offset, strings_size);
+    strings_size = 4;
+    for (i = 0; i < symbol_count; i++)
+    {
+        const char* name = symbols[i].name;
+        if (name != NULL && strlen(name) > 8)
+        {
+            memcpy(file + offset + strings_size, name, strlen(name) + 1);
+            strings_size += strlen(name) + 1;
+        }
+    }
+    return offset + strings_size;
+}
+
+/**
+ * @brief Builds and opens a test object.
+ *
+ * @param   machine_id      The object's `COFF_MACH_*` machine ID.
+ * @param   sections        The object's sections.
+ * @param   section_count   The number of sections.
+ * @param   symbols         The object's symbol table records.
+ * @param   symbol_count    The number of symbol table records.
+ * @param   file            Receives the object file.
+ * @param   file_size       The size of `file`, in bytes.
+ * @param   view            Receives a view of the object file.
+ * @param   object          Receives the open object.
+ * @return  1 if the object was opened; 0 otherwise.
+ */
+static int open_test_object(uint16_ne machine_id,
+                            const struct test_section* sections,
+                            unsigned int section_count,
+                            const struct test_symbol* symbols,
+                            unsigned int symbol_count,
+                            uint8_ne* file,
+                            size_t file_size,
+                            struct image_view* view,
+                            struct coff_object* object)
+{
+    size_t size = build_object(machine_id,
+                               sections,
+                               section_count,
+                               symbols,
+                               symbol_count,
+                               file,
+                               file_size);
+    if (size == 0
+        || !sniff_image(file, size, view)
+        || !open_coff_object(object, view))
+    {
+        fprintf(stderr, "test object for machine 0x%x does not open\n",
+                (unsigned int) machine_id);
+        failures++;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Resolves `ext_val` to `EXTERNAL_DISTANCE` past the load address
+ * `context` points to, and nothing else.
+ */
+static int resolve(void* context,
+                   const char* name,
+                   size_t length,
+                   uint64_ne* address)
+{
+    resolve_calls++;
+    if (length == 7 && memcmp(name, "ext_val", 7) == 0)
+    {
+        *address = *(const uint64_ne*) context + EXTERNAL_DISTANCE;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks a 32-bit little endian field in the loaded object.
+ */
+static void check_uint32(const uint8_ne* memory,
+                         size_t offset,
+                         uint32_ne expected,
+                         const char* what)
+{
+    uint32_ne actual = READ_UINT32_LE(memory + offset);
+    if (actual != expected)
+    {
+        fprintf(stderr, "%s at +0x%lx is 0x%lx; expected 0x%lx\n",
+                what,
+                (unsigned long) offset,
+                (unsigned long) actual,
+                (unsigned long) expected);
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks a 64-bit little endian field in the loaded object.
+ */
+static void check_uint64(const uint8_ne* memory,
+                         size_t offset,
+                         uint64_ne expected,
+                         const char* what)
+{
+    uint64_ne actual = READ_UINT64_LE(memory + offset);
+    if (actual != expected)
+    {
+        fprintf(stderr, "%s at +0x%lx is 0x%lx%08lx; expected 0x%lx%08lx\n",
+                what,
+                (unsigned long) offset,
+                (unsigned long) (actual >> 32),
+                (unsigned long) (actual & 0xffffffff),
+                (unsigned long) (expected >> 32),
+                (unsigned long) (expected & 0xffffffff));
+        failures++;
+    }
+}
+
+/**
+ * @brief Links the AMD64 test object at a load address, and checks every
+ * patched field.
+ *
+ * @param   object          The open test object.
+ * @param   load_address    The address to link the object at.
+ */
+static void check_amd64_link(const struct coff_object* object,
+                             uint64_ne load_address)
+{
+    static uint8_ne memory[256];
+    static const uint8_ne stub_code[] = { 0xff, 0x25, 0, 0, 0, 0 };
+    uint64_ne section_addresses[MAXIMUM_SECTIONS];
+    uint64_ne symbol_addresses[MAXIMUM_SYMBOLS];
+    uint64_ne external_address = load_address + EXTERNAL_DISTANCE;
+    struct coff_object arm;
+    struct coff_link link;
+    link.memory = memory;
+    link.memory_size = sizeof(memory);
+    link.load_address = load_address;
+    link.section_addresses = section_addresses;
+    link.symbol_addresses = symbol_addresses;
+    link.resolve = resolve;
+    link.context = &load_address;
+    if (!link_coff_object(object, &link))
+    {
+        fprintf(stderr, "link_coff_object failed at 0x%lx\n",
+                (unsigned long) load_address);
+        failures++;
+        return;
+    }
+    if (section_addresses[0] != load_address
+        || section_addresses[4] != load_address + 0x54
+        || section_addresses[5] != COFF_UNRESOLVED_ADDRESS)
+    {
+        fprintf(stderr, "sections are misplaced\n");
+        failures++;
+    }
+    if (symbol_addresses[5] != load_address
+        || symbol_addresses[6] != external_address
+        || symbol_addresses[8] != load_address)
+    {
+        fprintf(stderr, "symbols are misresolved\n");
+        failures++;
+    }
+    check_uint32(memory, 0x06, 0x50 - 0x0e, "REL32_4 to .bss");
+    check_uint32(memory, 0x0f, 0x70 - 0x13, "call through stub");
+    check_uint32(memory, 0x15, 0x30 - 0x19, "REL32 to long name");
+    check_uint32(memory, 0x1b, 0x50 - 0x1f, "REL32 to .bss");
+    check_uint32(memory, 0x22, 0x38 - 0x26, "REL32 with addend");
+    check_uint64(memory, 0x38, load_address + 0x44, "ADDR64 with addend");
+    check_uint32(memory, 0x54, 0x20, "ADDR32NB");
+    check_uint32(memory, 0x58, 8, "SECREL");
+    if (READ_UINT16_LE(memory + 0x5c) != 2)
+    {
+        fprintf(stderr, "SECTION is %u; expected 2\n",
+                (unsigned int) READ_UINT16_LE(memory + 0x5c));
+        failures++;
+    }
+    check_uint64(memory, 0x64, load_address, "ADDR64 to weak external");
+    if (memcmp(memory + 0x70, stub_code, sizeof(stub_code)) != 0
+        || memcmp(memory + 0x80, stub_code, sizeof(stub_code)) != 0)
+    {
+        fprintf(stderr, "stubs do not jump through their address\n");
+        failures++;
+    }
+    check_uint64(memory, 0x76, external_address, "ext_val stub");
+    check_uint64(memory, 0x86, load_address, "maybe stub");
+    check_uint32(memory, 0x90, 6, "first stub index");
+    check_uint32(memory, 0x94, 8, "second stub index");
+
+    /* Objects for unsupported machines are rejected before any work. */
+    arm = *object;
+    arm.header.machine_id = COFF_MACH_ARM;
+    resolve_calls = 0;
+    memset(memory, 0xaa, sizeof(memory));
+    if (link_coff_object(&arm, &link)
+        || resolve_calls != 0
+        || memory[0] != 0xaa)
+    {
+        fprintf(stderr, "unsupported machine was linked\n");
+        failures++;
+    }
+}
+
+/**
+ * @brief Links a far call in a code section and in a data section, and
+ * checks only the code section uses a stub.
+ */
+static void check_far_calls(void)
+{
+    static uint8_ne file[1024];
+    static uint8_ne memory[64];
+    uint64_ne section_addresses[1];
+    uint64_ne symbol_addresses[1];
+    uint64_ne load_address = 0x10000;
+    struct image_view view;
+    struct coff_object object;
+    struct coff_link link;
+    link.memory = memory;
+    link.memory_size = sizeof(memory);
+    link.load_address = load_address;
+    link.section_addresses = section_addresses;
+    link.symbol_addresses = symbol_addresses;
+    link.resolve = resolve;
+    link.context = &load_address;
+    if (open_test_object(COFF_MACH_AMD64,
+                         far_code_sections,
+                         COUNT(far_code_sections),
+                         far_symbols,
+                         COUNT(far_symbols),
+                         file,
+                         sizeof(file),
+                         &view,
+                         &object))
+    {
+        if (!link_coff_object(&object, &link))
+        {
+            fprintf(stderr, "far call in code section failed to link\n");
+            failures++;
+        }
+        else
+        {
+            check_uint32(memory, 1, 0x10 - 5, "far call through stub");
+        }
+    }
+    if (open_test_object(COFF_MACH_AMD64,
+                         far_data_sections,
+                         COUNT(far_data_sections),
+                         far_symbols,
+                         COUNT(far_symbols),
+                         file,
+                         sizeof(file),
+                         &view,
+                         &object)
+        && link_coff_object(&object, &link))
+    {
+        fprintf(stderr, "far reference in data section used a stub\n");
+        failures++;
+    }
+}
+
+/**
+ * @brief Links the I386 test object, and checks every patched field.
+ */
+static void check_i386_link(void)
+{
+    static uint8_ne file[1024];
+    static uint8_ne memory[64];
+    uint64_ne section_addresses[COUNT(i386_sections)];
+    uint64_ne symbol_addresses[COUNT(i386_symbols)];
+    uint64_ne load_address = 0x400000;
+    struct image_view view;
+    struct coff_object object;
+    struct coff_link link;
+    size_t size;
+    size_t alignment;
+    if (!open_test_object(COFF_MACH_I386,
+                          i386_sections,
+                          COUNT(i386_sections),
+                          i386_symbols,
+                          COUNT(i386_symbols),
+                          file,
+                          sizeof(file),
+                          &view,
+                          &object))
+    {
+        return;
+    }
+    if (!get_coff_object_layout(&object, &size, &alignment)
+        || size != 0x28
+        || alignment != 16)
+    {
+        fprintf(stderr, "I386 layout is %lu bytes, aligned to %lu\n",
+                (unsigned long) size,
+                (unsigned long) alignment);
+        failures++;
+    }
+    link.memory = memory;
+    link.memory_size = sizeof(memory);
+    link.load_address = load_address;
+    link.section_addresses = section_addresses;
+    link.symbol_addresses = symbol_addresses;
+    link.resolve = NULL;
+    link.context = NULL;
+    if (!link_coff_object(&object, &link))
+    {
+        fprintf(stderr, "I386 link_coff_object failed\n");
+        failures++;
+        return;
+    }
+    check_uint32(memory, 0x01, 0x400014, "I386 DIR32");
+    check_uint32(memory, 0x06, 0x10 - 0x0a, "I386 REL32");
+    check_uint32(memory, 0x14, 0x11, "I386 _counter");
+    check_uint32(memory, 0x18, 0x400018, "I386 DIR32 with addend");
+    check_uint32(memory, 0x1c, 0x10, "I386 DIR32NB");
+    check_uint32(memory, 0x20, 0x12, "I386 SECREL with addend");
+    if (READ_UINT16_LE(memory + 0x24) != 1)
+    {
+        fprintf(stderr, "I386 SECTION is %u; expected 1\n",
+                (unsigned int) READ_UINT16_LE(memory + 0x24));
+        failures++;
+    }
+}
+
+int main(void)
+{
+    static uint8_ne file[4096];
+    struct image_view view;
+    struct coff_object object;
+    size_t size;
+    size_t alignment;
+    if (open_test_object(COFF_MACH_AMD64,
+                         amd64_sections,
+                         COUNT(amd64_sections),
+                         amd64_symbols,
+                         COUNT(amd64_symbols),
+                         file,
+                         sizeof(file),
+                         &view,
+                         &object))
+    {
+        if (!get_coff_object_layout(&object, &size, &alignment)
+            || size != 0x98
+            || alignment != 16)
+        {
+            fprintf(stderr, "layout is %lu bytes, aligned to %lu\n",
+                    (unsigned long) size,
+                    (unsigned long) alignment);
+            failures++;
+        }
+        check_amd64_link(&object, 0x10000);
+        check_amd64_link(&object, 0);
+    }
+    check_far_calls();
+    check_i386_link();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,363 @@
+/**
+ * @file resource_test.c
+ * @brief Checks resource lookups in resource.c.
+ *
+ * resource_test builds a small PE32 image with a `.rsrc` section at RVA
+ * 0x1000 and a `.data` section at RVA 0x2000, and looks resources up in it.
+ * The resource tree, at offsets from its root, is:
+ *
+ * - 0x00: the root. Names "ALPHA" -> 0xa8 and "BETA" -> 0xc0; IDs 16 -> 0x30
+ *   and 24 -> 0x68.
+ * - 0x30: version resources. ID 1 -> 0x48.
+ * - 0x48: languages. IDs 0x409 -> data "EN", and 0x809 -> data "GB".
+ * - 0x68: manifest resources, with IDs out of order: 3, 1, 2 -> 0x90.
+ * - 0x90: languages. ID 0x409 -> data "MANIFEST", stored in `.data`.
+ * - 0xa8: ID 7 -> data at an RVA outside the image, and ID 8 -> a data
+ *   entry outside the tree.
+ * - 0xc0: one entry, whose name lies outside the tree.
+ * - 0xd8: name strings; 0xf0: data entries; 0x140: resource data "ENGB".
+ *
+ * @author H Paterson.
+ * @copyright Boost Software License 1.0.
+ * @date 18/10/2026.
+ */
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "format/format.h"
+#include "format/pecoff/resource.h"
+#include "platform/endian.h"
+#include "platform/types.h"
+
+
+/**
+ * @def RSRC_OFFSET
+ * @brief The file offset of the `.rsrc` section, and the resource tree.
+ */
+#define RSRC_OFFSET     0x200
+
+/**
+ * @def RSRC_RVA
+ * @brief The RVA of the `.rsrc` section.
+ */
+#define RSRC_RVA        0x1000
+
+/**
+ * @def TREE_SIZE
+ * @brief The size of the resource tree, as given by its data directory.
+ */
+#define TREE_SIZE       0x148
+
+/**
+ * @def DATA_OFFSET
+ * @brief The file offset of the `.data` section.
+ */
+#define DATA_OFFSET     0x400
+
+/**
+ * @def DATA_RVA
+ * @brief The RVA of the `.data` section.
+ */
+#define DATA_RVA        0x2000
+
+/**
+ * @def IMAGE_SIZE
+ * @brief The size of the test image, in bytes.
+ */
+#define IMAGE_SIZE      0x500
+
+/**
+ * @def SUBDIRECTORY
+ * @brief Marks a directory entry's target as a subdirectory.
+ */
+#define SUBDIRECTORY    0x80000000
+
+/**
+ * @def STRING_NAME
+ * @brief Marks a directory entry's name as a string.
+ */
+#define STRING_NAME     0x80000000
+
+/**
+ * @var failures
+ * @brief The number of checks which have failed.
+ */
+static int failures = 0;
+
+/**
+ * @brief Writes a directory table, and returns a pointer to its entries.
+ */
+static uint8_ne* write_directory(uint8_ne* tree,
+                                 uint32_ne offset,
+                                 uint16_ne name_count,
+                                 uint16_ne id_count)
+{
+    WRITE_UINT16_LE(tree + offset + 12, name_count);
+    WRITE_UINT16_LE(tree + offset + 14, id_count);
+    return tree + offset + 16;
+}
+
+/**
+ * @brief Writes the `index`th entry of a directory.
+ */
+static void write_entry(uint8_ne* entries,
+                        unsigned int index,
+                        uint32_ne name,
+                        uint32_ne target)
+{
+    WRITE_UINT32_LE(entries + index * 8, name);
+    WRITE_UINT32_LE(entries + index * 8 + 4, target);
+}
+
+/**
+ * @brief Writes a length prefixed UTF-16 name string.
+ */
+static void write_name(uint8_ne* tree, uint32_ne offset, const char* name)
+{
+    size_t length = strlen(name);
+    size_t i;
+    WRITE_UINT16_LE(tree + offset, length);
+    for (i = 0; i < length; i++)
+    {
+        WRITE_UINT16_LE(tree + offset + 2 + i * 2, name[i]);
+    }
+}
+
+/**
+ * @brief Writes a resource data entry.
+ */
+static void write_data_entry(uint8_ne* tree,
+                             uint32_ne offset,
+                             uint32_ne rva,
+                             uint32_ne size)
+{
+    WRITE_UINT32_LE(tree + offset, rva);
+    WRITE_UINT32_LE(tree + offset + 4, size);
+}
+
+/**
+ * @brief Writes the test image.
+ *
+ * @param   image   Receives the image; `IMAGE_SIZE` bytes.
+ */
+static void build_image(uint8_ne* image)
+{
+    uint8_ne* coff = image + 0x44;
+    uint8_ne* optional = coff + 20;
+    uint8_ne* sections = optional + 0xe0;
+    uint8_ne* tree = image + RSRC_OFFSET;
+    uint8_ne* entries;
+    memset(image, 0, IMAGE_SIZE);
+    image[0] = 'M';
+    image[1] = 'Z';
+    WRITE_UINT32_LE(image + 0x3c, 0x40);
+    memcpy(image + 0x40, "PE\0\0", 4);
+    WRITE_UINT16_LE(coff, 0x14c);
+    WRITE_UINT16_LE(coff + 2, 2);
+    WRITE_UINT16_LE(coff + 16, 0xe0);
+    WRITE_UINT16_LE(coff + 18, 0x0102);
+    WRITE_UINT16_LE(optional, 0x10b);
+    WRITE_UINT32_LE(optional + 92, 16);
+    WRITE_UINT32_LE(optional + 96 + 2 * 8, RSRC_RVA);
+    WRITE_UINT32_LE(optional + 96 + 2 * 8 + 4, TREE_SIZE);
+    memcpy(sections, ".rsrc", 5);
+    WRITE_UINT32_LE(sections + 8, 0x200);
+    WRITE_UINT32_LE(sections + 12, RSRC_RVA);
+    WRITE_UINT32_LE(sections + 16, 0x200);
+    WRITE_UINT32_LE(sections + 20, RSRC_OFFSET);
+    memcpy(sections + 40, ".data", 5);
+    WRITE_UINT32_LE(sections + 48, 0x100);
+    WRITE_UINT32_LE(sections + 52, DATA_RVA);
+    WRITE_UINT32_LE(sections + 56, 0x100);
+    WRITE_UINT32_LE(sections + 60, DATA_OFFSET);
+
+    entries = write_directory(tree, 0x00, 2, 2);
+    write_entry(entries, 0, STRING_NAME | 0xd8, SUBDIRECTORY | 0xa8);
+    write_entry(entries, 1, STRING_NAME | 0xe4, SUBDIRECTORY | 0xc0);
+    write_entry(entries, 2, 16, SUBDIRECTORY | 0x30);
+    write_entry(entries, 3, 24, SUBDIRECTORY | 0x68);
+    entries = write_directory(tree, 0x30, 0, 1);
+    write_entry(entries, 0, 1, SUBDIRECTORY | 0x48);
+    entries = write_directory(tree, 0x48, 0, 2);
+    write_entry(entries, 0, 0x409, 0xf0);
+    write_entry(entries, 1, 0x809, 0x100);
+    entries = write_directory(tree, 0x68, 0, 3);
+    write_entry(entries, 0, 3, SUBDIRECTORY | 0x90);
+    write_entry(entries, 1, 1, SUBDIRECTORY | 0x90);
+    write_entry(entries, 2, 2, SUBDIRECTORY | 0x90);
+    entries = write_directory(tree, 0x90, 0, 1);
+    write_entry(entries, 0, 0x409, 0x110);
+    entries = write_directory(tree, 0xa8, 0, 2);
+    write_entry(entries, 0, 7, 0x120);
+    write_entry(entries, 1, 8, TREE_SIZE - 8);
+    entries = write_directory(tree, 0xc0, 1, 0);
+    write_entry(entries, 0, STRING_NAME | 0x7ffffff0, 0x130);
+    write_name(tree, 0xd8, "ALPHA");
+    write_name(tree, 0xe4, "BETA");
+    write_data_entry(tree, 0xf0, RSRC_RVA + 0x140, 2);
+    write_data_entry(tree, 0x100, RSRC_RVA + 0x142, 2);
+    write_data_entry(tree, 0x110, DATA_RVA, 8);
+    write_data_entry(tree, 0x120, 0x9000, 4);
+    write_data_entry(tree, 0x130, RSRC_RVA + 0x140, 2);
+    memcpy(tree + 0x140, "ENGB", 4);
+    memcpy(image + DATA_OFFSET, "MANIFEST", 8);
+}
+
+/**
+ * @brief Checks find_resource() finds a resource with the expected data.
+ */
+static void check_found(const struct resource_tree* tree,
+                        uint32_ne type,
+                        uint32_ne id,
+                        uint32_ne language,
+                        const char* expected)
+{
+    struct resource_data data;
+    if (!find_resource(tree, type, id, language, &data)
+        || data.size != strlen(expected)
+        || memcmp(data.data, expected, data.size) != 0)
+    {
+        fprintf(stderr, "resource %lu/%lu/0x%lx is not \"%s\"\n",
+                (unsigned long) type,
+                (unsigned long) id,
+                (unsigned long) language,
+                expected);
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks find_resource() does not find a resource.
+ */
+static void check_missing(const struct resource_tree* tree,
+                          uint32_ne type,
+                          uint32_ne id,
+                          uint32_ne language)
+{
+    struct resource_data data;
+    if (find_resource(tree, type, id, language, &data))
+    {
+        fprintf(stderr, "resource %lu/%lu/0x%lx is found\n",
+                (unsigned long) type,
+                (unsigned long) id,
+                (unsigned long) language);
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks find_resource_name() finds, or does not find, a name.
+ */
+static void check_name(const struct resource_directory* directory,
+                       const char* name,
+                       int expected)
+{
+    uint16_ne units[16];
+    struct resource_entry entry;
+    size_t length = strlen(name);
+    size_t i;
+    for (i = 0; i < length; i++)
+    {
+        units[i] = (uint16_ne) name[i];
+    }
+    if (find_resource_name(directory, units, length, &entry) != expected)
+    {
+        fprintf(stderr, "name \"%s\" is %s\n",
+                name,
+                expected ? "not found" : "found");
+        failures++;
+    }
+}
+
+int main(void)
+{
+    static uint8_ne image[IMAGE_SIZE];
+    struct image_view view;
+    struct resource_tree tree;
+    struct resource_directory root;
+    struct resource_directory directory;
+    struct resource_entry entry;
+    struct resource_data data;
+    const uint8_ne* name;
+    uint16_ne length;
+    build_image(image);
+    if (!sniff_image(image, IMAGE_SIZE, &view)
+        || view.format != IMAGE_FORMAT_PE
+        || !open_resource_tree(&tree, &view)
+        || !open_resource_root(&tree, &root))
+    {
+        fprintf(stderr, "test image has no resource tree\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Hits and misses by ID, in sorted directories. */
+    check_found(&tree, RESOURCE_TYPE_VERSION, 1, 0x409, "EN");
+    check_found(&tree, RESOURCE_TYPE_VERSION, 1, 0x809, "GB");
+    check_found(&tree, RESOURCE_TYPE_VERSION, 1, RESOURCE_LANGUAGE_ANY, "EN");
+    check_missing(&tree, RESOURCE_TYPE_VERSION, 1, 0x407);
+    check_missing(&tree, RESOURCE_TYPE_VERSION, 2, RESOURCE_LANGUAGE_ANY);
+    check_missing(&tree, RESOURCE_TYPE_ICON, 1, RESOURCE_LANGUAGE_ANY);
+
+    /* Names are compared ignoring the case of ASCII letters. */
+    check_name(&root, "ALPHA", 1);
+    check_name(&root, "beta", 1);
+    check_name(&root, "Alpha", 1);
+    check_name(&root, "ALPH", 0);
+    check_name(&root, "GAMMA", 0);
+    if (!get_resource_entry(&root, 0, &entry)
+        || !get_resource_name(&entry, &name, &length)
+        || length != 5
+        || READ_UINT16_LE(name) != 'A')
+    {
+        fprintf(stderr, "first name is not \"ALPHA\"\n");
+        failures++;
+    }
+
+    /* Unsorted directories are trusted, unless the tree is validated. */
+    if (!validate_resource_directory(&root))
+    {
+        fprintf(stderr, "root is not sorted\n");
+        failures++;
+    }
+    check_missing(&tree, RESOURCE_TYPE_MANIFEST, 3, RESOURCE_LANGUAGE_ANY);
+    tree.validate = 1;
+    check_found(&tree, RESOURCE_TYPE_MANIFEST, 3, 0x409, "MANIFEST");
+    check_found(&tree, RESOURCE_TYPE_MANIFEST, 2, 0x409, "MANIFEST");
+    check_missing(&tree, RESOURCE_TYPE_MANIFEST, 4, RESOURCE_LANGUAGE_ANY);
+    check_found(&tree, RESOURCE_TYPE_VERSION, 1, 0x809, "GB");
+    if (!find_resource_id(&root, RESOURCE_TYPE_MANIFEST, &entry)
+        || !open_resource_subdirectory(&entry, &directory)
+        || validate_resource_directory(&directory)
+        || directory.id_order != RESOURCE_ORDER_UNSORTED)
+    {
+        fprintf(stderr, "manifest directory is not found unsorted\n");
+        failures++;
+    }
+    tree.validate = 0;
+
+    /* Names and data outside the tree or image are rejected. */
+    if (!get_resource_entry(&root, 1, &entry)
+        || !open_resource_subdirectory(&entry, &directory)
+        || !get_resource_entry(&directory, 0, &entry)
+        || get_resource_name(&entry, &name, &length))
+    {
+        fprintf(stderr, "name outside the tree is read\n");
+        failures++;
+    }
+    check_name(&directory, "X", 0);
+    if (!get_resource_entry(&root, 0, &entry)
+        || !open_resource_subdirectory(&entry, &directory)
+        || !find_resource_id(&directory, 7, &entry)
+        || read_resource_data(&entry, &data)
+        || !find_resource_id(&directory, 8, &entry)
+        || read_resource_data(&entry, &data))
+    {
+        fprintf(stderr, "data outside the image is read\n");
+        failures++;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}